@@ -23,12 +23,23 @@
 
 #include "app_controller.h"
 
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iomanip>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
 
 #include "arg_parser.h"
+#include "batch_diff.h"
 #include "diff.h"
-#include "file_handler.h"
+#include "diff_client.h"
+#include "diff_state.h"
+#include "diff_server.h"
+#include "directory_diff.h"
+#include "file_helper.h"
+#include "streaming_diff.h"
 #include "string_helper.h"
 
 /**
@@ -44,8 +55,9 @@ AppController::AppController(int argc, char* argv[], std::vector<Argument>& args
     options(),          // Program options
     originalFilename(), // Path to the original file
     modifiedFilename(), // Path to the modified file
-    original(),         // Lines from the original file
-    modified() { }      // Lines from the modified file
+    fileOriginal(),     // Contents of the original file
+    fileModified(),     // Contents of the modified file
+    fileCache(nullptr) { } // Files are not cached by default
 
 /**
  * @brief Display help (usage)
@@ -60,15 +72,74 @@ void AppController::displayHelp(void)
         << "  -h, --help\t\t\tDisplay this help message and exit.\n"
         << "  -c, --color\t\t\tEnable color support when printing to console.\n"
         << "  -a, --force-ansi\t\tUse ANSI escape codes for colors on Windows systems.\n"
+        << "  -r, --recursive\t\tCompare files in both directories and their\n"
+        << "\t\t\t\tsubdirectories on all threads.\n"
+        << "  --batch FILE\t\t\tCompare each pair of files listed in FILE\n"
+        << "\t\t\t\t(- for standard input), one pair per line,\n"
+        << "\t\t\t\tand output the difference in the same order.\n"
         << "  -o, --out-file FILE\t\tRedirect output to the file instead of a console.\n"
-        << "  -n, --lines NUM\t\tNumber of lines for context (3 by default).\n\n"
+        << "\t\t\t\tFILE ending with .gz is compressed with gzip.\n"
+        << "  -n, --lines NUM\t\tNumber of lines for context (3 by default).\n"
+        << "  --algorithm NAME\t\tAlgorithm for calculating the difference:\n"
+        << "\t\t\t\tmyers (default), patience, histogram\n"
+        << "\t\t\t\tor legacy.\n"
+        << "  -t, --threads NUM\t\tNumber of threads for calculating the difference\n"
+        << "\t\t\t\t(1 by default, 0 to use all cores).\n"
+        << "  -d, --minimal\t\t\tAlways find the shortest edit script.\n"
+        << "  --speed-large-files\t\tGive up on the shortest edit script earlier\n"
+        << "\t\t\t\tfor large files with many changes.\n"
+        << "  --bit-parallel-budget NUM\tUse the bit-parallel algorithm if N*M/64\n"
+        << "\t\t\t\tdoes not exceed NUM (4194304 by default,\n"
+        << "\t\t\t\t0 to disable).\n"
+        << "  --window NUM\t\t\tRead files in windows of NUM lines and output\n"
+        << "\t\t\t\thunks as they are found, so that memory usage\n"
+        << "\t\t\t\tdoes not depend on the size of files\n"
+        << "\t\t\t\t(0 by default, read whole files).\n"
+        << "  --read-method NAME\t\tMethod of reading files in streaming mode:\n"
+        << "\t\t\t\tpread (default) or io_uring, which keeps\n"
+        << "\t\t\t\tseveral reads in flight and falls back\n"
+        << "\t\t\t\tto pread when it is not available.\n"
+        << "  --text\t\t\tCompare binary files as text instead of\n"
+        << "\t\t\t\treporting only whether they differ.\n"
+        << "  --strip-trailing-cr\t\tIgnore \"\\r\" at the end of lines that end\n"
+        << "\t\t\t\twith \"\\r\\n\".\n"
+        << "  --cache DIR\t\t\tKeep calculated differences in DIR and reuse\n"
+        << "\t\t\t\tthem for files with the same contents.\n"
+        << "  --cache-size NUM\t\tMaximum size of the cache in megabytes\n"
+        << "\t\t\t\t(100 by default), the least recently used\n"
+        << "\t\t\t\tdifferences are removed first.\n"
+        << "  --incremental FILE\t\tSave the difference to FILE and, while the\n"
+        << "\t\t\t\toriginal file stays the same, compare only\n"
+        << "\t\t\t\tthe changed part of the modified file next time.\n"
+        << "\t\t\t\tLines are matched by 128-bit hashes, which are\n"
+        << "\t\t\t\tnot proof against lines made to collide.\n"
+        << "  --stats\t\t\tPrint statistics of the calculation to the\n"
+        << "\t\t\t\tstandard error.\n"
+        << "  --serve SOCKET\t\tRun as a server that calculates the difference\n"
+        << "\t\t\t\tfor clients connected to the Unix domain\n"
+        << "\t\t\t\tSOCKET and keeps recently read files in memory.\n"
+        << "  --client SOCKET\t\tLet the server listening on SOCKET calculate\n"
+        << "\t\t\t\tthe difference, with the same output.\n\n"
         << "Files:\n"
-        << "  original\t\t\tOriginal file.\n"
-        << "  modified\t\t\tNew (modified) file.\n\n"
+        << "  original\t\t\tOriginal file (directory with -r).\n"
+        << "  modified\t\t\tNew (modified) file (directory with -r).\n"
+        << "Files compressed with gzip are decompressed automatically.\n"
+        << "The exit status is 1 if any file could not be compared, including single\n"
+        << "pairs of --batch and -r.\n\n"
         << "Examples:\n"
         << "  cdiff original.txt modified.txt\n"
         << "  cdiff -c -a original.txt modified.txt\n"
-        << "  cdiff -o output.diff -n 5 original.txt modified.txt\n";
+        << "  cdiff -o output.diff -n 5 original.txt modified.txt\n"
+        << "  cdiff -t 2 -o output.diff.gz original.txt modified.txt\n"
+        << "  cdiff -r -t 0 original_dir modified_dir\n"
+        << "  cdiff --batch manifest.txt -t 0\n"
+        << "  cdiff --cache ~/.cache/cdiff original.txt modified.txt\n"
+        << "  cdiff --incremental state.bin --stats original.txt modified.txt\n"
+        << "  cdiff --serve /tmp/cdiff.sock\n"
+        << "  cdiff --client /tmp/cdiff.sock -c original.txt modified.txt\n"
+        << "  cdiff -t 8 large_original.txt large_modified.txt\n"
+        << "  cdiff --window 100000 huge_original.txt huge_modified.txt\n"
+        << "  cdiff --window 100000 --read-method io_uring huge_original.txt huge_modified.txt\n";
 }
 
 /**
@@ -97,6 +168,15 @@ bool AppController::parseArguments(void)
         argParser.getArgumentValue("--color") == "true");
     options.setForceAnsiCodes(argParser.getArgumentValue("-a") == "true" ||
         argParser.getArgumentValue("--force-ansi") == "true");
+    options.setMinimal(argParser.getArgumentValue("-d") == "true" ||
+        argParser.getArgumentValue("--minimal") == "true");
+    options.setSpeedLargeFiles(
+        argParser.getArgumentValue("--speed-large-files") == "true");
+    options.setTreatAsText(argParser.getArgumentValue("--text") == "true");
+    options.setStripTrailingCr(argParser.getArgumentValue("--strip-trailing-cr") == "true");
+    options.setRecursive(argParser.getArgumentValue("-r") == "true" ||
+        argParser.getArgumentValue("--recursive") == "true");
+    options.setBatchManifest(argParser.getArgumentValue("--batch"));
 
     std::string outputFilePath;
 
@@ -139,10 +219,129 @@ bool AppController::parseArguments(void)
         );
     }
 
+    const std::string algorithm = argParser.getArgumentValue("--algorithm");
+
+    if(algorithm == "myers")
+        options.setAlgorithm(Algorithm::Myers);
+    else if(algorithm == "patience")
+        options.setAlgorithm(Algorithm::Patience);
+    else if(algorithm == "histogram")
+        options.setAlgorithm(Algorithm::Histogram);
+    else if(algorithm == "legacy")
+        options.setAlgorithm(Algorithm::Legacy);
+    else
+        throw std::invalid_argument("unknown algorithm " + algorithm);
+
+    std::string threads;
+
+    if(argParser.getArgumentValue("-t") != "1")
+        threads = argParser.getArgumentValue("-t");
+    else
+        threads = argParser.getArgumentValue("--threads");
+
+    // Convert string to unsigned int
+    options.setThreadCount(StringHelper::str2uint(threads));
+
+    // Use all available cores
+    if(options.getThreadCount() == 0)
+        options.setThreadCount(std::max(1u, std::thread::hardware_concurrency()));
+
+    // Convert string to unsigned int
+    options.setBitParallelBudget(
+        StringHelper::str2uint(argParser.getArgumentValue("--bit-parallel-budget"))
+    );
+
+    // Convert string to unsigned int
+    options.setWindowSize(
+        StringHelper::str2uint(argParser.getArgumentValue("--window"))
+    );
+
+    options.setCacheDirectory(argParser.getArgumentValue("--cache"));
+    // Convert string to unsigned int
+    options.setCacheSize(
+        StringHelper::str2uint(argParser.getArgumentValue("--cache-size"))
+    );
+
+    const std::string readMethod = argParser.getArgumentValue("--read-method");
+
+    if(readMethod == "pread")
+        options.setReadMethod(ReadMethod::Pread);
+    else if(readMethod == "io_uring")
+        options.setReadMethod(ReadMethod::IoUring);
+    else
+        throw std::invalid_argument("unknown read method " + readMethod);
+
+    options.setServeSocket(argParser.getArgumentValue("--serve"));
+    options.setClientSocket(argParser.getArgumentValue("--client"));
+
+    options.setIncrementalState(argParser.getArgumentValue("--incremental"));
+    options.setStats(argParser.getArgumentValue("--stats") == "true");
+
+    // Both work only with the edit script of a single pair of files
+    if((!options.getIncrementalState().empty() || options.getStats()) &&
+       (options.getRecursive() || !options.getBatchManifest().empty() ||
+        options.getWindowSize() > 0))
+        throw std::invalid_argument("invalid arguments");
+
+    const std::vector<std::string>& files = argParser.getPositionalArguments();
+
+    if(!options.getServeSocket().empty())
+    {
+        // The server does not start another server for its clients
+        if(fileCache != nullptr || !options.getClientSocket().empty() ||
+           !files.empty() || options.getRecursive() ||
+           !options.getBatchManifest().empty())
+            throw std::invalid_argument("invalid arguments");
+
+        return true;
+    }
+
+    // Arguments are checked by the server. Requests of
+    // the server are already sent by a client
+    if(!options.getClientSocket().empty())
+    {
+        if(fileCache == nullptr) return true;
+
+        options.setClientSocket("");
+    }
+
+    // Pairs of files are listed in the manifest in batch mode
+    if(!options.getBatchManifest().empty())
+    {
+        if(!files.empty() || options.getRecursive())
+            throw std::invalid_argument("invalid arguments");
+
+        return true;
+    }
+
+    // Program requires exactly 2 files if neither
+    // '-h' nor '--help' is the first argument
+    if(files.size() < 2)
+        throw std::invalid_argument("missing required arguments");
+
+    if(files.size() > 2)
+        throw std::invalid_argument("invalid arguments");
+
     // Path to the original file
-    originalFilename = argv[argc - 2];
+    originalFilename = files[0];
     // Path to the modified file
-    modifiedFilename = argv[argc - 1];
+    modifiedFilename = files[1];
+
+    if(options.getRecursive())
+    {
+        // Paths of files inside directories are joined with '/'
+        while(originalFilename.size() > 1 && (originalFilename.back() == '/' ||
+              originalFilename.back() == '\\'))
+            originalFilename.pop_back();
+
+        while(modifiedFilename.size() > 1 && (modifiedFilename.back() == '/' ||
+              modifiedFilename.back() == '\\'))
+            modifiedFilename.pop_back();
+
+        if(!FileHelper::isDirectory(originalFilename) ||
+           !FileHelper::isDirectory(modifiedFilename))
+            throw std::invalid_argument("both paths must be directories with -r");
+    }
 
     if(!StringHelper::isValidFilename(originalFilename) ||
        !StringHelper::isValidFilename(modifiedFilename))
@@ -151,32 +350,280 @@ bool AppController::parseArguments(void)
     return true;
 }
 
+/**
+ * @brief Map the file into memory, or get it from the cache
+ *
+ * @param fname Path to the file
+ * @return File
+ */
+std::shared_ptr<MappedFile> AppController::loadFile(const std::string& fname)
+{
+    if(fileCache != nullptr)
+        return fileCache->get(fname);
+
+    return std::make_shared<MappedFile>(fname);
+}
+
 /**
  * @brief Read contents of the original and modified files
  *
  */
 void AppController::readFileContents(void)
 {
-    // Open files
-    FileHandler fileOriginal(originalFilename, std::ios::in);
-    FileHandler fileModified(modifiedFilename, std::ios::in);
+    // Files are read while the difference is calculated
+    // in directory, batch and streaming modes
+    if(options.getRecursive() || !options.getBatchManifest().empty() ||
+       options.getWindowSize() > 0) return;
 
-    // Read each line into the vector
-    original = fileOriginal.read();
-    modified = fileModified.read();
+    // Map files into memory. Mappings stay alive until the end
+    // of the program, so lines refer to them without copying.
+    // Each file is opened and queried only once
+    if(options.getThreadCount() > 1)
+    {
+        // Load the modified file on another thread. Waiting for
+        // the disk and decompression overlap for both files
+        std::future<std::shared_ptr<MappedFile>> modifiedLoader = std::async(
+            std::launch::async, [this]() { return loadFile(modifiedFilename); });
 
-    // Close file streams
-    fileOriginal.close();
-    fileModified.close();
+        // If the original file fails to load, the future waits
+        // for the loader and releases its file
+        fileOriginal = loadFile(originalFilename);
+        // Rethrows the exception of the loader, if any
+        fileModified = modifiedLoader.get();
+    }
+    else
+    {
+        fileOriginal = loadFile(originalFilename);
+        fileModified = loadFile(modifiedFilename);
+    }
 }
 
 /**
  * @brief Calculate and output the difference between files
  *
+ * @return true if all files were compared, false if some files
+ * of a batch or a directory could not be compared
  */
-void AppController::calculateDiff(void)
+bool AppController::calculateDiff(void)
 {
-    Diff diff(original, modified, originalFilename, modifiedFilename, options);
-    diff.calculate();
+    if(!options.getBatchManifest().empty())
+    {
+        BatchDiff diff(options);
+        diff.readManifest(options.getBatchManifest());
+        return diff.print();
+    }
+
+    if(options.getRecursive())
+    {
+        DirectoryDiff diff(originalFilename, modifiedFilename, options);
+        return diff.print();
+    }
+
+    if(options.getWindowSize() > 0)
+    {
+        StreamingDiff diff(originalFilename, modifiedFilename, options);
+        diff.print();
+        return true;
+    }
+
+    // Identical files have no difference, so their lines are not even
+    // split. Only the header is written, the same as for any equal files.
+    // The incremental state and statistics still need the lines though
+    const bool identical = fileOriginal->hasSameContents(*fileModified);
+
+    if(identical && options.getIncrementalState().empty() && !options.getStats())
+    {
+        Diff diff(*fileOriginal, *fileModified, options);
+        diff.print();
+        return true;
+    }
+
+    // Lines of binary files are meaningless
+    if(!identical && !options.getTreatAsText() &&
+       (fileOriginal->isBinary() || fileModified->isBinary()))
+    {
+        Diff diff(*fileOriginal, *fileModified, options);
+        diff.printBinary();
+        return true;
+    }
+
+    // The file cache gives the same file for both inputs with the same name
+    if(options.getThreadCount() > 1 && fileOriginal != fileModified)
+    {
+        // Lines of both files are split and hashed in parallel
+        std::future<void> modifiedSplitter = std::async(std::launch::async,
+            [this]() { fileModified->splitLines(options.getStripTrailingCr()); });
+
+        fileOriginal->splitLines(options.getStripTrailingCr());
+        modifiedSplitter.get();
+    }
+    else
+    {
+        fileOriginal->splitLines(options.getStripTrailingCr());
+        fileModified->splitLines(options.getStripTrailingCr());
+    }
+
+    Diff diff(*fileOriginal, *fileModified, options);
+    // How the edit script was obtained, reported in statistics
+    std::string source = "full comparison";
+    std::size_t compared = fileOriginal->getLines().size() + fileModified->getLines().size();
+    bool incremental = false;
+    std::unique_ptr<DiffState> state;
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    if(!options.getIncrementalState().empty())
+    {
+        state.reset(new DiffState(options.getIncrementalState()));
+
+        if(state->load(*fileOriginal, options))
+        {
+            compared = diff.calculate(*state);
+            source = "incremental";
+            incremental = true;
+        }
+    }
+
+    if(!incremental && !options.getCacheDirectory().empty())
+    {
+        ResultCache cache(options.getCacheDirectory(),
+                          static_cast<std::uint64_t>(options.getCacheSize()) * 1048576);
+
+        if(diff.calculate(cache))
+        {
+            source = "cache";
+            compared = 0;
+        }
+    }
+    else if(!incremental)
+    {
+        diff.calculate();
+    }
+
+    const double elapsed = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    if(state) state->save(*fileOriginal, *fileModified, options, diff.getScript());
+
     diff.print();
+
+    if(options.getStats())
+        printStats(diff, source, compared, elapsed, incremental);
+
+    return true;
+}
+
+/**
+ * @brief Print statistics of the calculation to the standard error.
+ * The incremental re-diff is compared with the full one, which is
+ * calculated once more for that
+ *
+ * @param diff Calculated difference
+ * @param source How the edit script was obtained
+ * @param compared Number of lines in both files that were compared
+ * @param elapsed Time of the calculation in milliseconds
+ * @param incremental Whether the previous edit script was updated
+ */
+void AppController::printStats(const Diff& diff, const std::string& source,
+                               std::size_t compared, double elapsed, bool incremental)
+{
+    const std::size_t originalCount = fileOriginal->getLines().size();
+    const std::size_t modifiedCount = fileModified->getLines().size();
+    std::size_t removedCount = 0, insertedCount = 0;
+
+    for(const EditRun& run : diff.getScript().getRuns())
+    {
+        if(run.getChange() == Change::Remove) removedCount += run.getLength();
+        else if(run.getChange() == Change::Insert) insertedCount += run.getLength();
+    }
+
+    std::cerr << std::fixed << std::setprecision(3)
+              << "Lines: " << originalCount << " original, "
+              << modifiedCount << " modified\n"
+              << "Line endings: " << (fileOriginal->hasCarriageReturns() ? "\\r\\n" : "\\n")
+              << " original, " << (fileModified->hasCarriageReturns() ? "\\r\\n" : "\\n")
+              << " modified\n"
+              << "Changes: " << removedCount << " removed, "
+              << insertedCount << " inserted\n"
+              << "Edit script: " << source << ", " << compared << " of "
+              << originalCount + modifiedCount << " lines compared\n"
+              << "Time: " << elapsed << " ms\n";
+
+    if(!incremental) return;
+
+    Diff full(*fileOriginal, *fileModified, options);
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    full.calculate();
+    const double fullElapsed = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::cerr << "Full re-diff: " << fullElapsed << " ms, speedup "
+              << std::setprecision(1) << fullElapsed / std::max(elapsed, 0.001) << "x\n";
+}
+
+/**
+ * @brief Keep files in the cache between runs. Used by the server,
+ * which also rejects the options that start a server or a client
+ *
+ * @param fileCache Cache of files, nullptr to read files each time
+ */
+void AppController::setFileCache(FileCache* fileCache)
+{
+    this->fileCache = fileCache;
+}
+
+/**
+ * @brief Parse arguments, then calculate and output the difference,
+ * serve clients or send the request to the server
+ *
+ * @return Exit code of the program
+ */
+int AppController::run(void)
+{
+    try
+    {
+        // Parse command line arguments
+        if(!parseArguments())
+        {
+            // Close application if help was displayed
+            return 0;
+        }
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << '\n'
+                  << "Use \'cdiff -h\' or  \'cdiff --help\' "
+                  << "for more information\n";
+        return 1;
+    }
+
+    try
+    {
+        if(!options.getServeSocket().empty())
+        {
+            DiffServer server(options.getServeSocket(), args);
+            server.run();
+            return 0;
+        }
+
+        if(!options.getClientSocket().empty())
+        {
+            DiffClient client(options.getClientSocket());
+            return client.run(argc, argv);
+        }
+
+        // Read contents of the files
+        readFileContents();
+        // Calculate and output the difference between files.
+        // Errors of single pairs are already reported
+        if(!calculateDiff()) return 1;
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
 }
\ No newline at end of file
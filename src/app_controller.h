@@ -24,10 +24,15 @@
 #ifndef APP_CONTROLLER_H
 #define APP_CONTROLLER_H
 
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "argument.h"
+#include "diff.h"
+#include "file_cache.h"
+#include "mapped_file.h"
 #include "options.h"
 
 /**
@@ -68,20 +73,45 @@ class AppController
          */
         std::string modifiedFilename;
         /**
-         * @brief Lines from the original file
+         * @brief Contents of the original file
          *
          */
-        std::vector<std::string> original;
+        std::shared_ptr<MappedFile> fileOriginal;
         /**
-         * @brief Lines from the modified file
+         * @brief Contents of the modified file
          *
          */
-        std::vector<std::string> modified;
+        std::shared_ptr<MappedFile> fileModified;
+        /**
+         * @brief Cache of files kept between runs, nullptr if files are not cached
+         *
+         */
+        FileCache* fileCache;
         /**
          * @brief Display help (usage)
          *
          */
         void displayHelp(void);
+        /**
+         * @brief Map the file into memory, or get it from the cache
+         *
+         * @param fname Path to the file
+         * @return File
+         */
+        std::shared_ptr<MappedFile> loadFile(const std::string& fname);
+        /**
+         * @brief Print statistics of the calculation to the standard error.
+         * The incremental re-diff is compared with the full one, which is
+         * calculated once more for that
+         *
+         * @param diff Calculated difference
+         * @param source How the edit script was obtained
+         * @param compared Number of lines in both files that were compared
+         * @param elapsed Time of the calculation in milliseconds
+         * @param incremental Whether the previous edit script was updated
+         */
+        void printStats(const Diff& diff, const std::string& source,
+                        std::size_t compared, double elapsed, bool incremental);
 
     public:
         /**
@@ -107,8 +137,24 @@ class AppController
         /**
          * @brief Calculate and output the difference between files
          *
+         * @return true if all files were compared, false if some files
+         * of a batch or a directory could not be compared
+         */
+        bool calculateDiff(void);
+        /**
+         * @brief Keep files in the cache between runs. Used by the server,
+         * which also rejects the options that start a server or a client
+         *
+         * @param fileCache Cache of files, nullptr to read files each time
+         */
+        void setFileCache(FileCache* fileCache);
+        /**
+         * @brief Parse arguments, then calculate and output the difference,
+         * serve clients or send the request to the server
+         *
+         * @return Exit code of the program
          */
-        void calculateDiff(void);
+        int run(void);
 };
 
 #endif // APP_CONTROLLER_H
\ No newline at end of file
@@ -34,8 +34,9 @@
  */
 ArgParser::ArgParser(int argc, char* argv[]) :
     ELEMENT_DOES_NOT_EXIST(-1),
-    argv(argv + 1, argv + argc) { } // Convert an array of C strings (char*)
+    argv(argv + 1, argv + argc),    // Convert an array of C strings (char*)
                                     // to string vector
+    positional() { }
 
 /**
  * @brief Initialize command line arguments parser
@@ -48,7 +49,8 @@ ArgParser::ArgParser(int argc, char* argv[],
                      const std::vector<Argument>& args) :
                      ELEMENT_DOES_NOT_EXIST(-1),
                      argv(argv + 1, argv + argc),
-                     args(args) { }
+                     args(args),
+                     positional() { }
 
 /**
  * @brief Add a valid command line argument
@@ -125,14 +127,28 @@ std::string ArgParser::getArgumentValue(const std::string &name)
 }
 
 /**
- * @brief Parse command line arguments
+ * @brief Get arguments after the options, e.g. names of files
+ *
+ * @return Positional arguments
+ */
+const std::vector<std::string>& ArgParser::getPositionalArguments(void) const
+{
+    return positional;
+}
+
+/**
+ * @brief Parse command line arguments. Options are parsed until
+ * the first argument that is not an option, that argument and
+ * all following ones are positional
  *
  */
 void ArgParser::parse(void)
 {
     const std::size_t argvCount = argv.size();
     const char delim = '=';
-    std::size_t index, pos;
+    std::size_t i, index, pos;
+
+    positional.clear();
 
     // If the first argument is '-h' or '--help'
     if(argvCount > 0 && (argv[0] == "-h" || argv[0] == "--help"))
@@ -143,13 +159,7 @@ void ArgParser::parse(void)
         return;
     }
 
-    // Program requires at least 2 arguments if neither
-    // '-h' nor '--help' is the first argument
-    if(argvCount < 2)
-        throw std::invalid_argument("missing required arguments");
-
-    // Check up to 2 last arguments
-    for(std::size_t i = 0; i < argvCount - 2; i++)
+    for(i = 0; i < argvCount; i++)
     {
         // Check if an argument is valid
         index = getArgumentIndex(argv[i]);
@@ -163,7 +173,7 @@ void ArgParser::parse(void)
             else // Non-boolean argument
             {
                 // Check the next argument for value
-                if((i + 1 < argvCount - 2) &&
+                if((i + 1 < argvCount) &&
                    getArgumentIndex(argv[i + 1]) == ELEMENT_DOES_NOT_EXIST)
                     args[index].setValue(argv[i + 1]);
                 else
@@ -172,24 +182,30 @@ void ArgParser::parse(void)
                 // Skip the next argument
                 i++;
             }
+
+            continue;
         }
-        else // String did not match argument name
-        {
-            // Find a delimiter in the string
-            pos = argv[i].find(delim);
 
-            // Delimiter was not found, argument is invalid
-            if(pos == std::string::npos)
-                throw std::invalid_argument("invalid arguments");
+        // Positional arguments do not start with '-'
+        if(argv[i].size() < 2 || argv[i][0] != '-') break;
 
-            // Check if a substring is a valid argument
-            index = getArgumentIndex(argv[i].substr(0, pos));
+        // Find a delimiter in the string
+        pos = argv[i].find(delim);
 
-            if(index == ELEMENT_DOES_NOT_EXIST)
-                throw std::invalid_argument("invalid arguments");
+        // Delimiter was not found, argument is invalid
+        if(pos == std::string::npos)
+            throw std::invalid_argument("invalid arguments");
 
-            // Extract value
-            args[index].setValue(argv[i].substr(pos + 1));
-        }
+        // Check if a substring is a valid argument
+        index = getArgumentIndex(argv[i].substr(0, pos));
+
+        if(index == ELEMENT_DOES_NOT_EXIST)
+            throw std::invalid_argument("invalid arguments");
+
+        // Extract value
+        args[index].setValue(argv[i].substr(pos + 1));
     }
+
+    // Remaining arguments are positional
+    positional.assign(argv.begin() + i, argv.end());
 }
\ No newline at end of file
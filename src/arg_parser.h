@@ -55,6 +55,11 @@ class ArgParser
          *
          */
         std::vector<Argument> args;
+        /**
+         * @brief Arguments after the options, e.g. names of files
+         *
+         */
+        std::vector<std::string> positional;
         /**
          * @brief Get the index of the argument
          *
@@ -103,7 +108,15 @@ class ArgParser
          */
         std::string getArgumentValue(const std::string& name);
         /**
-         * @brief Parse command line arguments
+         * @brief Get arguments after the options, e.g. names of files
+         *
+         * @return Positional arguments
+         */
+        const std::vector<std::string>& getPositionalArguments(void) const;
+        /**
+         * @brief Parse command line arguments. Options are parsed until
+         * the first argument that is not an option, that argument and
+         * all following ones are positional
          *
          */
         void parse(void);
@@ -0,0 +1,301 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "batch_diff.h"
+
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "diff.h"
+#include "mapped_file.h"
+#include "output_sink.h"
+#include "thread_pool.h"
+
+/**
+ * @brief Initialize parameters with specified values
+ *
+ * @param options Program options
+ */
+BatchDiff::BatchDiff(Options& options) :
+    options(options),       // Program options
+    originalFilenames(),    // No entries yet
+    modifiedFilenames(),    // No entries yet
+    messages(),             // No entries yet
+    resultCache()           // Created below if enabled
+{
+    if(!options.getCacheDirectory().empty())
+        resultCache.reset(new ResultCache(options.getCacheDirectory(),
+            static_cast<std::uint64_t>(options.getCacheSize()) * 1048576));
+}
+
+/**
+ * @brief Compare the pair of files and collect the difference
+ *
+ * @param originalFilename Name of the original file
+ * @param modifiedFilename Name of the modified file
+ * @param output String that receives the difference
+ * @param workspace Memory of the current thread
+ */
+void BatchDiff::comparePair(const std::string& originalFilename,
+                            const std::string& modifiedFilename,
+                            std::string& output,
+                            Workspace& workspace) const
+{
+    MappedFile original(originalFilename);
+    MappedFile modified(modifiedFilename);
+
+    // Sizes are compared first, so most changed files are not read twice
+    if(original.hasSameContents(modified)) return;
+
+    // Pairs already run in parallel, so each pair uses one thread.
+    // Colors are written as ANSI codes, because the output is buffered
+    Options pairOptions(options);
+    pairOptions.setThreadCount(1);
+    pairOptions.setForceAnsiCodes(true);
+
+    OutputSink sink(output);
+
+    if(!pairOptions.getTreatAsText() && (original.isBinary() || modified.isBinary()))
+    {
+        Diff diff(original, modified, pairOptions);
+        diff.writeBinary(sink);
+        return;
+    }
+
+    // Lines, hashes and the edit script are stored in the memory
+    // of the previous pair. It is given back when the pair is written
+    original.swapLines(workspace.originalLines, workspace.originalHashes);
+    modified.swapLines(workspace.modifiedLines, workspace.modifiedHashes);
+    original.splitLines(pairOptions.getStripTrailingCr());
+    modified.splitLines(pairOptions.getStripTrailingCr());
+
+    Diff diff(original, modified, pairOptions);
+    diff.swapStorage(workspace.diff);
+
+    if(resultCache)
+        diff.calculate(*resultCache);
+    else
+        diff.calculate();
+
+    diff.write(sink);
+
+    diff.swapStorage(workspace.diff);
+    original.swapLines(workspace.originalLines, workspace.originalHashes);
+    modified.swapLines(workspace.modifiedLines, workspace.modifiedHashes);
+}
+
+/**
+ * @brief Add the pair of files to compare
+ *
+ * @param originalFilename Name of the original file
+ * @param modifiedFilename Name of the modified file
+ */
+void BatchDiff::addPair(const std::string& originalFilename,
+                        const std::string& modifiedFilename)
+{
+    originalFilenames.push_back(originalFilename);
+    modifiedFilenames.push_back(modifiedFilename);
+    messages.push_back(std::string());
+}
+
+/**
+ * @brief Add the text that is written in place of a difference
+ *
+ * @param message Text
+ */
+void BatchDiff::addMessage(const std::string& message)
+{
+    originalFilenames.push_back(std::string());
+    modifiedFilenames.push_back(std::string());
+    messages.push_back(message);
+}
+
+/**
+ * @brief Add pairs of files from the manifest. Each line of the
+ * manifest contains two paths separated by a tab, or by spaces
+ * if paths contain none. Empty lines and lines starting with '#'
+ * are skipped
+ *
+ * @param fname Path to the manifest, "-" for the standard input
+ */
+void BatchDiff::readManifest(const std::string& fname)
+{
+    std::ifstream file;
+
+    if(fname != "-")
+    {
+        file.open(fname);
+
+        if(!file.is_open())
+            throw std::runtime_error("could not open " + fname);
+    }
+
+    std::istream& manifest = (fname == "-") ? std::cin : file;
+    std::string line, originalFilename, modifiedFilename, rest;
+    unsigned int lineNumber = 0;
+    std::size_t tab;
+
+    while(std::getline(manifest, line))
+    {
+        lineNumber++;
+
+        // Manifests written on Windows end lines with "\r\n"
+        if(!line.empty() && line.back() == '\r') line.pop_back();
+
+        if(line.empty() || line[0] == '#') continue;
+
+        tab = line.find('\t');
+
+        if(tab != std::string::npos)
+        {
+            originalFilename = line.substr(0, tab);
+            modifiedFilename = line.substr(tab + 1);
+        }
+        else
+        {
+            std::istringstream fields(line);
+            rest.clear();
+            originalFilename.clear();
+            modifiedFilename.clear();
+            fields >> originalFilename >> modifiedFilename >> rest;
+
+            if(!rest.empty()) modifiedFilename.clear();
+        }
+
+        if(originalFilename.empty() || modifiedFilename.empty())
+            throw std::invalid_argument("line " + std::to_string(lineNumber) +
+                                        " of the manifest is not a pair of files");
+
+        addPair(originalFilename, modifiedFilename);
+    }
+
+    if(manifest.bad())
+        throw std::runtime_error("could not read " + fname);
+}
+
+/**
+ * @brief Compare all pairs and print the difference
+ * to console or write it to file. Pairs that could not be compared
+ * are reported to the standard error without stopping other pairs
+ *
+ * @return true if all pairs were compared, false otherwise
+ */
+bool BatchDiff::print(void)
+{
+    const std::size_t count = messages.size();
+    // Output of each pair, written in the order of entries
+    std::vector<std::string> outputs(count);
+    // Buffers of written outputs, reused by the next pairs
+    std::vector<std::string> spare;
+    // Errors of each pair, reported without stopping other pairs
+    std::vector<std::string> errors(count);
+    // Whether the pair is compared
+    std::unique_ptr<std::atomic<bool>[]> done(new std::atomic<bool>[count]);
+    std::size_t i;
+    bool compared = true;
+
+    for(i = 0; i < count; i++)
+        done[i] = false;
+
+    std::unique_ptr<OutputSink> out(options.getOutputToFile() ?
+        new OutputSink(options.getOutputFilePath(), options.getThreadCount() > 1) :
+        new OutputSink());
+
+    ThreadPool pool(options.getThreadCount());
+    // Memory of each thread of the pool
+    std::vector<Workspace> workspaces(pool.getThreadCount());
+    // Pairs are submitted only a little ahead of the output,
+    // so finished but unwritten outputs do not pile up
+    const std::size_t ahead = 4 * pool.getThreadCount();
+    std::size_t submitted = 0;
+
+    for(i = 0; i < count; i++)
+    {
+        for(; submitted < count && submitted < i + ahead; submitted++)
+        {
+            if(!messages[submitted].empty())
+            {
+                done[submitted] = true;
+                continue;
+            }
+
+            const std::size_t index = submitted;
+
+            if(!spare.empty())
+            {
+                outputs[index].swap(spare.back());
+                spare.pop_back();
+            }
+
+            pool.submit([this, index, &outputs, &errors, &done, &pool, &workspaces]()
+            {
+                try
+                {
+                    comparePair(originalFilenames[index], modifiedFilenames[index],
+                                outputs[index], workspaces[pool.getCurrentIndex()]);
+                }
+                catch(const std::exception& e)
+                {
+                    errors[index] = e.what();
+                }
+
+                done[index] = true;
+            });
+        }
+
+        // Help the pool while the next pair in order is compared
+        while(!done[i])
+        {
+            if(!pool.runPendingTask())
+                std::this_thread::yield();
+        }
+
+        if(!messages[i].empty())
+        {
+            *out << messages[i];
+        }
+        else if(!errors[i].empty())
+        {
+            // Messages keep their place relative to the output
+            out->flush();
+            std::cerr << "Error: " << errors[i] << '\n';
+            compared = false;
+        }
+        else
+        {
+            *out << outputs[i];
+            outputs[i].clear();
+            spare.push_back(std::string());
+            spare.back().swap(outputs[i]);
+        }
+    }
+
+    out->finish();
+
+    return compared;
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BATCH_DIFF_H
+#define BATCH_DIFF_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "diff.h"
+#include "line_view.h"
+#include "options.h"
+#include "result_cache.h"
+
+/**
+ * @brief Class for calculating the difference between many pairs of files
+ * in one process. Pairs are compared on a thread pool, output of each pair
+ * is collected in its own buffer and written in the order the pairs were
+ * added, so the result does not depend on scheduling. Identical pairs
+ * produce no output
+ *
+ */
+class BatchDiff
+{
+    private:
+        /**
+         * @brief Memory of one thread, reused by all pairs the thread compares
+         *
+         */
+        struct Workspace
+        {
+            std::vector<LineView> originalLines;
+            std::vector<std::uint64_t> originalHashes;
+            std::vector<LineView> modifiedLines;
+            std::vector<std::uint64_t> modifiedHashes;
+            Diff::Storage diff;
+        };
+
+        /**
+         * @brief Program options
+         *
+         */
+        Options& options;
+        /**
+         * @brief Original file of each entry, empty for messages
+         *
+         */
+        std::vector<std::string> originalFilenames;
+        /**
+         * @brief Modified file of each entry, empty for messages
+         *
+         */
+        std::vector<std::string> modifiedFilenames;
+        /**
+         * @brief Text written instead of a difference, empty for pairs
+         *
+         */
+        std::vector<std::string> messages;
+        /**
+         * @brief Cache of edit scripts shared by all pairs, nullptr if disabled
+         *
+         */
+        std::unique_ptr<ResultCache> resultCache;
+        /**
+         * @brief Compare the pair of files and collect the difference
+         *
+         * @param originalFilename Name of the original file
+         * @param modifiedFilename Name of the modified file
+         * @param output String that receives the difference
+         * @param workspace Memory of the current thread
+         */
+        void comparePair(const std::string& originalFilename,
+                         const std::string& modifiedFilename,
+                         std::string& output,
+                         Workspace& workspace) const;
+
+    public:
+        /**
+         * @brief Initialize parameters with specified values
+         *
+         * @param options Program options
+         */
+        explicit BatchDiff(Options& options);
+        /**
+         * @brief Add the pair of files to compare
+         *
+         * @param originalFilename Name of the original file
+         * @param modifiedFilename Name of the modified file
+         */
+        void addPair(const std::string& originalFilename,
+                     const std::string& modifiedFilename);
+        /**
+         * @brief Add the text that is written in place of a difference
+         *
+         * @param message Text
+         */
+        void addMessage(const std::string& message);
+        /**
+         * @brief Add pairs of files from the manifest. Each line of the
+         * manifest contains two paths separated by a tab, or by spaces
+         * if paths contain none. Empty lines and lines starting with '#'
+         * are skipped
+         *
+         * @param fname Path to the manifest, "-" for the standard input
+         */
+        void readManifest(const std::string& fname);
+        /**
+         * @brief Compare all pairs and print the difference
+         * to console or write it to file. Pairs that could not be compared
+         * are reported to the standard error without stopping other pairs
+         *
+         * @return true if all pairs were compared, false otherwise
+         */
+        bool print(void);
+};
+
+#endif // BATCH_DIFF_H
\ No newline at end of file
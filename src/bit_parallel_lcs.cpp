@@ -0,0 +1,186 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bit_parallel_lcs.h"
+
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * @brief Initialize parameters with specified values
+ *
+ * @param original IDs of lines from the original file
+ * @param modified IDs of lines from the modified file
+ * @param idCount Number of unique IDs in both files
+ */
+BitParallelLcs::BitParallelLcs(const std::vector<std::uint32_t>& original,
+                               const std::vector<std::uint32_t>& modified,
+                               std::uint32_t idCount) :
+                               original(original),
+                               modified(modified),
+                               head(idCount, -1),
+                               next(original.size(), -1) { }
+
+/**
+ * @brief Count bits set to 1 in the word
+ *
+ * @param word Word
+ * @return Number of bits set to 1
+ */
+int BitParallelLcs::countBits(std::uint64_t word)
+{
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<int>((word * 0x0101010101010101ULL) >> 56);
+}
+
+/**
+ * @brief Count bits set to 0 among the lowest bits of the row
+ *
+ * @param row First word of the row
+ * @param bits Number of bits to check
+ * @return Number of bits set to 0
+ */
+int BitParallelLcs::countZeros(const std::uint64_t* row, int bits)
+{
+    int zeros = 0;
+
+    for(; bits >= 64; bits -= 64, row++)
+        zeros += 64 - countBits(*row);
+
+    if(bits > 0)
+        zeros += bits - countBits(*row & ((1ULL << bits) - 1));
+
+    return zeros;
+}
+
+/**
+ * @brief Get the number of words the table takes for ranges
+ *
+ * @param n Number of lines in the original range
+ * @param m Number of lines in the modified range
+ * @return Number of 64-bit words
+ */
+std::uint64_t BitParallelLcs::getTableSize(int n, int m)
+{
+    return static_cast<std::uint64_t>((n + 63) / 64) * (m + 1);
+}
+
+/**
+ * @brief Calculate the difference between ranges of two sequences.
+ * Only flags of lines within the ranges are changed
+ *
+ * @param aLo Start of the range in the original file
+ * @param aHi End of the range in the original file
+ * @param bLo Start of the range in the modified file
+ * @param bHi End of the range in the modified file
+ * @param removed Flags of removed lines in the original file
+ * @param inserted Flags of inserted lines in the modified file
+ */
+void BitParallelLcs::calculate(int aLo, int aHi, int bLo, int bHi,
+                               std::vector<char>& removed,
+                               std::vector<char>& inserted)
+{
+    const int n = aHi - aLo;
+    const int m = bHi - bLo;
+    // Number of words in a row
+    const std::size_t words = (n + 63) / 64;
+
+    // Row j describes the table row after j lines of the modified range.
+    // Bit i is 0 if the LCS grows at line i of the original range
+    std::vector<std::uint64_t> rows(words * (m + 1), ~0ULL);
+    // Positions of the current line of the modified range
+    std::vector<std::uint64_t> matches(words, 0);
+    std::uint64_t carry, sum, v, u;
+    std::size_t w;
+    int i, j, length;
+
+    // Chain positions of each line in the original range
+    for(i = aHi - 1; i >= aLo; i--)
+    {
+        next[i] = head[original[i]];
+        head[original[i]] = i;
+    }
+
+    for(j = 1; j <= m; j++)
+    {
+        const std::uint64_t* previous = &rows[(j - 1) * words];
+        std::uint64_t* current = &rows[j * words];
+
+        // Set bits where the original range has the same line
+        for(i = head[modified[bLo + j - 1]]; i != -1; i = next[i])
+            matches[(i - aLo) / 64] |= 1ULL << ((i - aLo) % 64);
+
+        // V' = (V + (V & M)) | (V & ~M), with the carry
+        // of the addition passed between words
+        carry = 0;
+
+        for(w = 0; w < words; w++)
+        {
+            v = previous[w];
+            u = v & matches[w];
+            sum = v + u;
+            current[w] = sum + carry;
+            carry = (sum < v) || (current[w] < sum);
+            current[w] |= v & ~matches[w];
+        }
+
+        for(i = head[modified[bLo + j - 1]]; i != -1; i = next[i])
+            matches[(i - aLo) / 64] = 0;
+    }
+
+    // Reset chains for the next calculation
+    for(i = aLo; i < aHi; i++)
+        head[original[i]] = -1;
+
+    // Walk the table back from the end of both ranges
+    i = n;
+    j = m;
+    length = countZeros(&rows[m * words], n);
+
+    while(i > 0 && j > 0)
+    {
+        if((rows[j * words + (i - 1) / 64] >> ((i - 1) % 64)) & 1)
+        {
+            // LCS does not grow at this line of the original range
+            removed[aLo + i - 1] = 1;
+            i--;
+        }
+        else if(countZeros(&rows[(j - 1) * words], i) == length)
+        {
+            // LCS does not need this line of the modified range
+            inserted[bLo + j - 1] = 1;
+            j--;
+        }
+        else // Lines are equal and part of the LCS
+        {
+            i--;
+            j--;
+            length--;
+        }
+    }
+
+    std::fill(removed.begin() + aLo, removed.begin() + aLo + i, 1);
+    std::fill(inserted.begin() + bLo, inserted.begin() + bLo + j, 1);
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BIT_PARALLEL_LCS_H
+#define BIT_PARALLEL_LCS_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Class for calculating the longest common subsequence of two
+ * sequences with bit-parallel operations. Each row of the dynamic
+ * programming table is stored as a bit vector, so 64 cells are computed
+ * with a few word operations. Based on 'Bit-parallel LCS-length
+ * computation revisited' by Heikki Hyyro. All rows are kept for the
+ * traceback, so the table takes N*M/64 words
+ *
+ */
+class BitParallelLcs
+{
+    private:
+        /**
+         * @brief IDs of lines from the original file
+         *
+         */
+        const std::vector<std::uint32_t>& original;
+        /**
+         * @brief IDs of lines from the modified file
+         *
+         */
+        const std::vector<std::uint32_t>& modified;
+        /**
+         * @brief First position of each ID in the original range, or -1
+         *
+         */
+        std::vector<int> head;
+        /**
+         * @brief Next position of the same ID for each position
+         * in the original range, or -1
+         *
+         */
+        std::vector<int> next;
+        /**
+         * @brief Count bits set to 1 in the word
+         *
+         * @param word Word
+         * @return Number of bits set to 1
+         */
+        static int countBits(std::uint64_t word);
+        /**
+         * @brief Count bits set to 0 among the lowest bits of the row
+         *
+         * @param row First word of the row
+         * @param bits Number of bits to check
+         * @return Number of bits set to 0
+         */
+        static int countZeros(const std::uint64_t* row, int bits);
+
+    public:
+        /**
+         * @brief Initialize parameters with specified values
+         *
+         * @param original IDs of lines from the original file
+         * @param modified IDs of lines from the modified file
+         * @param idCount Number of unique IDs in both files
+         */
+        BitParallelLcs(const std::vector<std::uint32_t>& original,
+                       const std::vector<std::uint32_t>& modified,
+                       std::uint32_t idCount);
+        /**
+         * @brief Get the number of words the table takes for ranges
+         *
+         * @param n Number of lines in the original range
+         * @param m Number of lines in the modified range
+         * @return Number of 64-bit words
+         */
+        static std::uint64_t getTableSize(int n, int m);
+        /**
+         * @brief Calculate the difference between ranges of two sequences.
+         * Only flags of lines within the ranges are changed
+         *
+         * @param aLo Start of the range in the original file
+         * @param aHi End of the range in the original file
+         * @param bLo Start of the range in the modified file
+         * @param bHi End of the range in the modified file
+         * @param removed Flags of removed lines in the original file
+         * @param inserted Flags of inserted lines in the modified file
+         */
+        void calculate(int aLo, int aHi, int bLo, int bHi,
+                       std::vector<char>& removed,
+                       std::vector<char>& inserted);
+};
+
+#endif // BIT_PARALLEL_LCS_H
\ No newline at end of file
@@ -0,0 +1,416 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "block_reader.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_WIN32) // Windows
+#include <io.h>
+#else // POSIX
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+// io_uring is available only on Linux. Its system calls are made
+// directly, so that liburing is not needed
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define BLOCK_READER_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+#endif
+
+/**
+ * @brief Prepare reading of the file
+ *
+ * @param fd File descriptor, must stay open while the reader is used
+ * @param fname Filename, used in error messages
+ * @param useIoUring Whether to try io_uring before plain reads
+ */
+BlockReader::BlockReader(int fd, const std::string& fname, bool useIoUring) :
+    filename(fname),        // Path to the file
+    fd(fd),                 // Owned by the caller
+    seekable(false),        // Checked below
+    fileSize(0),            // Checked below
+    memory(),               // Allocated below
+    blocksRead(0),          // Nothing is read yet
+    blocksSubmitted(0),     // Nothing is submitted yet
+    results(),              // Used only by io_uring
+    ringFd(-1),             // Set up below
+    fixedBuffers(false),    // Set when slots are registered
+    sqRing(nullptr),        // Mapped when io_uring is set up
+    sqRingSize(0),          // Reported by the kernel
+    cqRing(nullptr),        // Mapped when io_uring is set up
+    cqRingSize(0),          // Reported by the kernel
+    sqEntries(nullptr),     // Mapped when io_uring is set up
+    sqEntriesSize(0),       // Reported by the kernel
+    sqTail(nullptr),        // Points into the mapping
+    sqMask(nullptr),        // Points into the mapping
+    sqArray(nullptr),       // Points into the mapping
+    cqHead(nullptr),        // Points into the mapping
+    cqTail(nullptr),        // Points into the mapping
+    cqMask(nullptr),        // Points into the mapping
+    cqEntries(nullptr)      // Points into the mapping
+{
+#if !defined(_WIN32) // POSIX
+    struct stat fileStat;
+
+    // Only regular files can be read at any offset
+    if(fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode))
+    {
+        seekable = true;
+        fileSize = fileStat.st_size;
+    }
+#endif // _WIN32
+
+    if(useIoUring && seekable && setupRing())
+        submitReads();
+    else
+        memory.resize(BLOCK_SIZE);
+}
+
+/**
+ * @brief Wait for reads in flight and release io_uring
+ *
+ */
+BlockReader::~BlockReader(void)
+{
+    if(ringFd == -1) return;
+
+    // The kernel must not write into freed memory
+    try
+    {
+        for(std::uint64_t block = blocksRead; block < blocksSubmitted; block++)
+            waitForSlot(block % QUEUE_DEPTH);
+    }
+    catch(...) { }
+
+    closeRing();
+}
+
+/**
+ * @brief Set up io_uring
+ *
+ * @return true if io_uring is ready, false if it is not available
+ */
+bool BlockReader::setupRing(void)
+{
+#if defined(BLOCK_READER_URING)
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    // Fails with ENOSYS on old kernels and with EPERM when it is disabled
+    ringFd = syscall(__NR_io_uring_setup, QUEUE_DEPTH, &params);
+
+    if(ringFd < 0)
+    {
+        ringFd = -1;
+        return false;
+    }
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+    // Newer kernels map both rings at once
+    if(params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if(cqRingSize > sqRingSize) sqRingSize = cqRingSize;
+        cqRingSize = sqRingSize;
+    }
+
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+
+    if(sqRing == MAP_FAILED)
+    {
+        sqRing = nullptr;
+        closeRing();
+        return false;
+    }
+
+    if(params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        cqRing = sqRing;
+    }
+    else
+    {
+        cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+
+        if(cqRing == MAP_FAILED)
+        {
+            cqRing = nullptr;
+            closeRing();
+            return false;
+        }
+    }
+
+    sqEntriesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqEntries = mmap(nullptr, sqEntriesSize, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+
+    if(sqEntries == MAP_FAILED)
+    {
+        sqEntries = nullptr;
+        closeRing();
+        return false;
+    }
+
+    char* sq = static_cast<char*>(sqRing);
+    char* cq = static_cast<char*>(cqRing);
+
+    sqTail = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+    cqHead = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+    cqEntries = cq + params.cq_off.cqes;
+
+    memory.resize(QUEUE_DEPTH * BLOCK_SIZE);
+    results.assign(QUEUE_DEPTH, static_cast<long>(PENDING));
+
+    // Fixed buffers are mapped by the kernel only once. Registration
+    // fails when the limit of locked memory is too low, then plain
+    // reads are used with the same slots
+    std::vector<struct iovec> slots(QUEUE_DEPTH);
+
+    for(unsigned int i = 0; i < QUEUE_DEPTH; i++)
+    {
+        slots[i].iov_base = memory.data() + i * BLOCK_SIZE;
+        slots[i].iov_len = BLOCK_SIZE;
+    }
+
+    fixedBuffers = syscall(__NR_io_uring_register, ringFd,
+                           IORING_REGISTER_BUFFERS, slots.data(), QUEUE_DEPTH) == 0;
+
+    return true;
+#else
+    return false;
+#endif // BLOCK_READER_URING
+}
+
+/**
+ * @brief Release io_uring
+ *
+ */
+void BlockReader::closeRing(void)
+{
+#if defined(BLOCK_READER_URING)
+    if(sqEntries != nullptr) munmap(sqEntries, sqEntriesSize);
+    if(cqRing != nullptr && cqRing != sqRing) munmap(cqRing, cqRingSize);
+    if(sqRing != nullptr) munmap(sqRing, sqRingSize);
+
+    ::close(ringFd);
+    ringFd = -1;
+#endif // BLOCK_READER_URING
+}
+
+/**
+ * @brief Queue reads of blocks while there are free slots
+ *
+ */
+void BlockReader::submitReads(void)
+{
+#if defined(BLOCK_READER_URING)
+    const std::uint64_t blockCount = (fileSize + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    struct io_uring_sqe* entries = static_cast<struct io_uring_sqe*>(sqEntries);
+    unsigned int tail = *sqTail;
+    unsigned int queued = 0;
+
+    // Slots of blocks that were handed out before are free again
+    while(blocksSubmitted < blockCount && blocksSubmitted < blocksRead + QUEUE_DEPTH)
+    {
+        const unsigned int slot = blocksSubmitted % QUEUE_DEPTH;
+        const unsigned int index = tail & *sqMask;
+        const std::uint64_t offset = blocksSubmitted * BLOCK_SIZE;
+        struct io_uring_sqe* entry = &entries[index];
+
+        std::memset(entry, 0, sizeof(*entry));
+        entry->opcode = fixedBuffers ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        entry->fd = fd;
+        entry->off = offset;
+        entry->addr = reinterpret_cast<std::uintptr_t>(memory.data() + slot * BLOCK_SIZE);
+        entry->len = (fileSize - offset < BLOCK_SIZE) ? fileSize - offset : BLOCK_SIZE;
+        entry->buf_index = slot;
+        entry->user_data = slot;
+        sqArray[index] = index;
+
+        results[slot] = PENDING;
+        blocksSubmitted++;
+        queued++;
+        tail++;
+    }
+
+    if(queued == 0) return;
+
+    // Entries must be visible to the kernel before the tail
+    __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+
+    while(queued > 0)
+    {
+        const long submitted = syscall(__NR_io_uring_enter, ringFd, queued, 0, 0, nullptr, 0);
+
+        if(submitted < 0)
+        {
+            if(errno == EINTR || errno == EAGAIN) continue;
+            throw std::runtime_error("could not read " + filename);
+        }
+
+        queued -= submitted;
+    }
+#endif // BLOCK_READER_URING
+}
+
+/**
+ * @brief Wait until the read of the slot completes
+ *
+ * @param slot Index of the slot
+ */
+void BlockReader::waitForSlot(unsigned int slot)
+{
+#if defined(BLOCK_READER_URING)
+    const struct io_uring_cqe* entries = static_cast<const struct io_uring_cqe*>(cqEntries);
+
+    while(results[slot] == PENDING)
+    {
+        unsigned int head = *cqHead;
+        const unsigned int tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+
+        // Reads may complete in any order
+        for(; head != tail; head++)
+        {
+            const struct io_uring_cqe& entry = entries[head & *cqMask];
+            results[entry.user_data] = entry.res;
+        }
+
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+        if(results[slot] != PENDING) break;
+
+        if(syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+           errno != EINTR)
+            throw std::runtime_error("could not read " + filename);
+    }
+#else
+    (void)slot;
+#endif // BLOCK_READER_URING
+}
+
+/**
+ * @brief Read as much as possible into the buffer with a blocking call
+ *
+ * @param out Output buffer
+ * @param capacity Size of the output buffer in bytes
+ * @param offset Offset in the file, used only for seekable files
+ * @return Number of bytes read, less than capacity only at the end of the file
+ */
+std::size_t BlockReader::readBlocking(char* out, std::size_t capacity, std::uint64_t offset)
+{
+    std::size_t done = 0;
+
+    while(done < capacity)
+    {
+#if defined(_WIN32) // Windows
+        (void)offset;
+        const int count = _read(fd, out + done, static_cast<unsigned int>(capacity - done));
+#else // POSIX
+        const ssize_t count = seekable ?
+            pread(fd, out + done, capacity - done, offset + done) :
+            read(fd, out + done, capacity - done);
+#endif // _WIN32
+
+        if(count < 0)
+        {
+            if(errno == EINTR) continue;
+            throw std::runtime_error("could not read " + filename);
+        }
+
+        if(count == 0) break;
+
+        done += count;
+    }
+
+    return done;
+}
+
+/**
+ * @brief Get the next block of the file. The block stays
+ * valid until the next call
+ *
+ * @param data Receives the pointer to the block
+ * @param size Receives the size of the block in bytes
+ * @return true if the block was read, false at the end of the file
+ */
+bool BlockReader::next(const char*& data, std::size_t& size)
+{
+    if(ringFd == -1)
+    {
+        // All blocks except the last one are full
+        size = readBlocking(memory.data(), BLOCK_SIZE, blocksRead * BLOCK_SIZE);
+        data = memory.data();
+        blocksRead++;
+        return size > 0;
+    }
+
+    if(blocksRead == (fileSize + BLOCK_SIZE - 1) / BLOCK_SIZE) return false;
+
+    // The previous block is released, so its slot gets the next read
+    submitReads();
+
+    const unsigned int slot = blocksRead % QUEUE_DEPTH;
+    const std::uint64_t offset = blocksRead * BLOCK_SIZE;
+    const std::size_t expected = (fileSize - offset < BLOCK_SIZE) ? fileSize - offset : BLOCK_SIZE;
+    char* block = memory.data() + slot * BLOCK_SIZE;
+
+    waitForSlot(slot);
+
+    if(results[slot] < 0)
+        throw std::runtime_error("could not read " + filename);
+
+    size = results[slot];
+
+    // Short reads are rare, the rest is read with a blocking call
+    if(size < expected)
+        size += readBlocking(block + size, expected - size, offset + size);
+
+    data = block;
+    blocksRead++;
+    return size > 0;
+}
+
+/**
+ * @brief Check if the file is read through io_uring
+ *
+ * @return true if io_uring is used, false otherwise
+ */
+bool BlockReader::usesIoUring(void) const
+{
+    return ringFd != -1;
+}
\ No newline at end of file
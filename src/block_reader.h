@@ -0,0 +1,242 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BLOCK_READER_H
+#define BLOCK_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Class that reads a file in large blocks, in order. On Linux
+ * regular files are read through io_uring, which keeps several reads
+ * in flight, so the device is busy while previous blocks are processed.
+ * Other files, and systems without io_uring, are read with pread
+ * or read one block at a time
+ *
+ */
+class BlockReader
+{
+    private:
+        /**
+         * @brief Size of each block in bytes
+         *
+         */
+        static const std::size_t BLOCK_SIZE = 1 << 20;
+        /**
+         * @brief Number of reads that are kept in flight
+         *
+         */
+        static const unsigned int QUEUE_DEPTH = 16;
+        /**
+         * @brief Result of a read that is still in flight
+         *
+         */
+        static const long PENDING = -0x7fffffffL;
+        /**
+         * @brief Path to the file, used in error messages
+         *
+         */
+        std::string filename;
+        /**
+         * @brief File descriptor, owned by the caller
+         *
+         */
+        int fd;
+        /**
+         * @brief Whether the file can be read at any offset
+         *
+         */
+        bool seekable;
+        /**
+         * @brief Size of the file in bytes, if it is seekable
+         *
+         */
+        std::uint64_t fileSize;
+        /**
+         * @brief Memory for blocks. io_uring uses one slot per read in flight
+         *
+         */
+        std::vector<char> memory;
+        /**
+         * @brief Number of blocks that were handed out
+         *
+         */
+        std::uint64_t blocksRead;
+        /**
+         * @brief Number of blocks that were submitted to io_uring
+         *
+         */
+        std::uint64_t blocksSubmitted;
+        /**
+         * @brief Result of the read in each slot, PENDING while it is in flight
+         *
+         */
+        std::vector<long> results;
+        /**
+         * @brief File descriptor of io_uring, -1 if it is not used
+         *
+         */
+        int ringFd;
+        /**
+         * @brief Whether slots are registered in io_uring as fixed buffers
+         *
+         */
+        bool fixedBuffers;
+        /**
+         * @brief Mapping of the submission queue ring
+         *
+         */
+        void* sqRing;
+        /**
+         * @brief Size of the mapping of the submission queue ring
+         *
+         */
+        std::size_t sqRingSize;
+        /**
+         * @brief Mapping of the completion queue ring, may be the same as sqRing
+         *
+         */
+        void* cqRing;
+        /**
+         * @brief Size of the mapping of the completion queue ring
+         *
+         */
+        std::size_t cqRingSize;
+        /**
+         * @brief Mapping of submission queue entries
+         *
+         */
+        void* sqEntries;
+        /**
+         * @brief Size of the mapping of submission queue entries
+         *
+         */
+        std::size_t sqEntriesSize;
+        /**
+         * @brief Tail of the submission queue
+         *
+         */
+        unsigned int* sqTail;
+        /**
+         * @brief Mask of indices of the submission queue
+         *
+         */
+        unsigned int* sqMask;
+        /**
+         * @brief Indices of entries in the submission queue
+         *
+         */
+        unsigned int* sqArray;
+        /**
+         * @brief Head of the completion queue
+         *
+         */
+        unsigned int* cqHead;
+        /**
+         * @brief Tail of the completion queue
+         *
+         */
+        unsigned int* cqTail;
+        /**
+         * @brief Mask of indices of the completion queue
+         *
+         */
+        unsigned int* cqMask;
+        /**
+         * @brief Entries of the completion queue
+         *
+         */
+        void* cqEntries;
+        /**
+         * @brief Set up io_uring
+         *
+         * @return true if io_uring is ready, false if it is not available
+         */
+        bool setupRing(void);
+        /**
+         * @brief Release io_uring
+         *
+         */
+        void closeRing(void);
+        /**
+         * @brief Queue reads of blocks while there are free slots
+         *
+         */
+        void submitReads(void);
+        /**
+         * @brief Wait until the read of the slot completes
+         *
+         * @param slot Index of the slot
+         */
+        void waitForSlot(unsigned int slot);
+        /**
+         * @brief Read as much as possible into the buffer with a blocking call
+         *
+         * @param out Output buffer
+         * @param capacity Size of the output buffer in bytes
+         * @param offset Offset in the file, used only for seekable files
+         * @return Number of bytes read, less than capacity only at the end of the file
+         */
+        std::size_t readBlocking(char* out, std::size_t capacity, std::uint64_t offset);
+
+    public:
+        /**
+         * @brief Prepare reading of the file
+         *
+         * @param fd File descriptor, must stay open while the reader is used
+         * @param fname Filename, used in error messages
+         * @param useIoUring Whether to try io_uring before plain reads
+         */
+        BlockReader(int fd, const std::string& fname, bool useIoUring);
+        /**
+         * @brief Wait for reads in flight and release io_uring
+         *
+         */
+        ~BlockReader(void);
+        /**
+         * @brief Reader owns the memory of blocks, so it cannot be copied
+         *
+         */
+        BlockReader(const BlockReader&) = delete;
+        BlockReader& operator=(const BlockReader&) = delete;
+        /**
+         * @brief Get the next block of the file. The block stays
+         * valid until the next call
+         *
+         * @param data Receives the pointer to the block
+         * @param size Receives the size of the block in bytes
+         * @return true if the block was read, false at the end of the file
+         */
+        bool next(const char*& data, std::size_t& size);
+        /**
+         * @brief Check if the file is read through io_uring
+         *
+         * @return true if io_uring is used, false otherwise
+         */
+        bool usesIoUring(void) const;
+};
+
+#endif // BLOCK_READER_H
\ No newline at end of file
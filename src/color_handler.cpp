@@ -23,15 +23,16 @@
 
 #include "color_handler.h"
 
-#include <iostream>
 #include <stdexcept>
 
 /**
  * @brief Initialize colors
  *
+ * @param out Output the colors are applied to
  * @param forceAnsi Force ANSI codes on Windows
  */
-ColorHandler::ColorHandler(bool forceAnsi) : useAnsi(forceAnsi)
+ColorHandler::ColorHandler(OutputSink& out, bool forceAnsi) :
+    out(out), useAnsi(forceAnsi)
 {
 #if defined(_WIN32) // Windows
     if(useAnsi) return;
@@ -67,9 +68,11 @@ ColorHandler::~ColorHandler(void)
 void ColorHandler::setColor(Color color) const
 {
     // Output ANSI escape code of the specified color
-    if(useAnsi) std::cout << ansiCodes[static_cast<int>(color)];
+    if(useAnsi) out << ansiCodes[static_cast<int>(color)];
 
 #if defined(_WIN32) // Windows
+    // Text written so far keeps the previous color
+    out.flush();
     // Set color attributes
     SetConsoleTextAttribute(hConsole, colorAttributes[static_cast<int>(color)]);
 #endif // _WIN32
@@ -82,9 +85,11 @@ void ColorHandler::setColor(Color color) const
 void ColorHandler::resetColor(void) const
 {
     // Output ANSI escape code for resetting the color
-    if(useAnsi) std::cout << ansiCodes[3];
+    if(useAnsi) out << ansiCodes[3];
 
 #if defined(_WIN32) // Windows
+    // Text written so far keeps the previous color
+    out.flush();
     // Set color attributes
     SetConsoleTextAttribute(hConsole, csbi.wAttributes);
 #endif // _WIN32
@@ -26,6 +26,8 @@
 
 #include <string>
 
+#include "output_sink.h"
+
 // Windows-specific
 #if defined(_WIN32)
 #include <windows.h>
@@ -49,6 +51,11 @@ enum class Color : int
 class ColorHandler
 {
     private:
+        /**
+         * @brief Output the colors are applied to
+         *
+         */
+        OutputSink& out;
         /**
          * @brief Whether to use ANSI escape codes for colors
          *
@@ -92,9 +99,10 @@ class ColorHandler
         /**
          * @brief Initialize colors
          *
+         * @param out Output the colors are applied to
          * @param forceAnsi Force ANSI codes on Windows
          */
-        ColorHandler(bool forceAnsi);
+        ColorHandler(OutputSink& out, bool forceAnsi);
         /**
          * @brief Restore default color on exit
          *
@@ -0,0 +1,241 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "compressor.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_WIN32) // Windows
+#include <io.h>
+#else // POSIX
+#include <unistd.h>
+#endif // _WIN32
+
+/**
+ * @brief Initialize zlib and start the background thread if needed
+ *
+ * @param fd File descriptor, must stay open until the compressor is finished
+ * @param fname Filename, used in error messages
+ * @param background Whether to compress on a separate thread
+ */
+Compressor::Compressor(int fd, const std::string& fname, bool background) :
+    filename(fname),        // Path to the file
+    fd(fd),                 // Owned by the caller
+    stream(),               // Initialized below
+    buffer(BUFFER_SIZE),    // Buffer is allocated once
+    background(background), // Whether to compress on a separate thread
+    worker(),               // Started below
+    queue(),                // No blocks yet
+    queueMutex(),           // Mutex for the queue
+    queueChanged(),         // Signaled when the queue changes
+    closing(false),         // Set by finish()
+    error(),                // No error yet
+    finished(false)         // Set by finish()
+{
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+
+    // 16 selects the gzip format instead of zlib
+    if(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                    16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        throw std::runtime_error("could not initialize compression of " + fname);
+
+    if(background)
+        worker = std::thread(&Compressor::run, this);
+}
+
+/**
+ * @brief Stop the background thread and release the state of zlib
+ *
+ */
+Compressor::~Compressor(void)
+{
+    stopWorker();
+    deflateEnd(&stream);
+}
+
+/**
+ * @brief Compress data and write the result to the file descriptor
+ *
+ * @param data Pointer to the first byte
+ * @param size Number of bytes
+ * @param flush Z_NO_FLUSH, or Z_FINISH for the end of the stream
+ */
+void Compressor::deflateData(const char* data, std::size_t size, int flush)
+{
+    while(true)
+    {
+        // zlib counts bytes in unsigned int
+        const std::size_t part = (size > UINT_MAX) ? UINT_MAX : size;
+
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        stream.avail_in = static_cast<uInt>(part);
+        data += part;
+        size -= part;
+
+        const int mode = (size == 0) ? flush : Z_NO_FLUSH;
+        int result;
+
+        do
+        {
+            stream.next_out = reinterpret_cast<Bytef*>(buffer.data());
+            stream.avail_out = static_cast<uInt>(buffer.size());
+
+            result = deflate(&stream, mode);
+
+            if(result == Z_STREAM_ERROR)
+                throw std::runtime_error("could not compress output to " + filename);
+
+            const char* out = buffer.data();
+            std::size_t count = buffer.size() - stream.avail_out;
+
+            while(count > 0)
+            {
+#if defined(_WIN32) // Windows
+                const int written = _write(fd, out, static_cast<unsigned int>(count));
+#else // POSIX
+                const ssize_t written = ::write(fd, out, count);
+#endif // _WIN32
+
+                if(written < 0)
+                {
+                    if(errno == EINTR) continue;
+                    throw std::runtime_error(std::string("could not write output: ") +
+                                             std::strerror(errno));
+                }
+
+                out += written;
+                count -= written;
+            }
+        } while(stream.avail_out == 0 || (mode == Z_FINISH && result != Z_STREAM_END));
+
+        if(size == 0) return;
+    }
+}
+
+/**
+ * @brief Compress queued blocks until the queue is closed
+ *
+ */
+void Compressor::run(void)
+{
+    std::vector<char> block;
+
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueChanged.wait(lock, [this]() { return closing || !queue.empty(); });
+
+            if(queue.empty()) return;
+
+            block.swap(queue.front());
+            queue.pop_front();
+        }
+
+        queueChanged.notify_all();
+
+        try
+        {
+            deflateData(block.data(), block.size(), Z_NO_FLUSH);
+        }
+        catch(...)
+        {
+            // The writer gets the error with the next block
+            std::lock_guard<std::mutex> lock(queueMutex);
+            error = std::current_exception();
+            queue.clear();
+            closing = true;
+            queueChanged.notify_all();
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Stop the background thread
+ *
+ */
+void Compressor::stopWorker(void)
+{
+    if(!worker.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        closing = true;
+    }
+
+    queueChanged.notify_all();
+    worker.join();
+}
+
+/**
+ * @brief Compress the data. On the background thread
+ * the data is copied, so it can be reused at once
+ *
+ * @param data Pointer to the first byte
+ * @param size Number of bytes
+ */
+void Compressor::write(const char* data, std::size_t size)
+{
+    if(size == 0) return;
+
+    if(!background)
+    {
+        deflateData(data, size, Z_NO_FLUSH);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(queueMutex);
+
+    // Memory stays bounded when output is produced faster than compressed
+    queueChanged.wait(lock, [this]() { return error || queue.size() < MAX_QUEUED; });
+
+    if(error) std::rethrow_exception(error);
+
+    queue.push_back(std::vector<char>(data, data + size));
+    lock.unlock();
+    queueChanged.notify_all();
+}
+
+/**
+ * @brief Compress everything written so far and end the gzip stream
+ *
+ */
+void Compressor::finish(void)
+{
+    if(finished) return;
+
+    finished = true;
+
+    // Queued blocks are compressed before the thread stops
+    stopWorker();
+
+    if(error) std::rethrow_exception(error);
+
+    deflateData(nullptr, 0, Z_FINISH);
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef COMPRESSOR_H
+#define COMPRESSOR_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
+
+/**
+ * @brief Class that compresses data with gzip and writes it to a file
+ * descriptor as it arrives. Compression can run on a separate thread,
+ * so that the caller is not blocked while data is compressed
+ *
+ */
+class Compressor
+{
+    private:
+        /**
+         * @brief Size of the buffer for compressed data in bytes
+         *
+         */
+        static const std::size_t BUFFER_SIZE = 262144;
+        /**
+         * @brief Maximum number of blocks waiting for the background thread
+         *
+         */
+        static const std::size_t MAX_QUEUED = 4;
+        /**
+         * @brief Path to the file, used in error messages
+         *
+         */
+        std::string filename;
+        /**
+         * @brief File descriptor compressed data is written to
+         *
+         */
+        int fd;
+        /**
+         * @brief State of zlib
+         *
+         */
+        z_stream stream;
+        /**
+         * @brief Buffer for compressed data
+         *
+         */
+        std::vector<char> buffer;
+        /**
+         * @brief Whether blocks are compressed on the background thread
+         *
+         */
+        bool background;
+        /**
+         * @brief Thread that compresses queued blocks
+         *
+         */
+        std::thread worker;
+        /**
+         * @brief Blocks waiting for the background thread
+         *
+         */
+        std::deque<std::vector<char>> queue;
+        /**
+         * @brief Mutex for the queue
+         *
+         */
+        std::mutex queueMutex;
+        /**
+         * @brief Signaled when the queue changes
+         *
+         */
+        std::condition_variable queueChanged;
+        /**
+         * @brief Whether no more blocks will be queued
+         *
+         */
+        bool closing;
+        /**
+         * @brief Error of the background thread, rethrown to the caller
+         *
+         */
+        std::exception_ptr error;
+        /**
+         * @brief Whether the gzip trailer is written
+         *
+         */
+        bool finished;
+        /**
+         * @brief Compress data and write the result to the file descriptor
+         *
+         * @param data Pointer to the first byte
+         * @param size Number of bytes
+         * @param flush Z_NO_FLUSH, or Z_FINISH for the end of the stream
+         */
+        void deflateData(const char* data, std::size_t size, int flush);
+        /**
+         * @brief Compress queued blocks until the queue is closed
+         *
+         */
+        void run(void);
+        /**
+         * @brief Stop the background thread
+         *
+         */
+        void stopWorker(void);
+
+    public:
+        /**
+         * @brief Initialize zlib and start the background thread if needed
+         *
+         * @param fd File descriptor, must stay open until the compressor is finished
+         * @param fname Filename, used in error messages
+         * @param background Whether to compress on a separate thread
+         */
+        Compressor(int fd, const std::string& fname, bool background);
+        /**
+         * @brief Stop the background thread and release the state of zlib
+         *
+         */
+        ~Compressor(void);
+        /**
+         * @brief State of zlib and the thread cannot be copied
+         *
+         */
+        Compressor(const Compressor&) = delete;
+        Compressor& operator=(const Compressor&) = delete;
+        /**
+         * @brief Compress the data. On the background thread
+         * the data is copied, so it can be reused at once
+         *
+         * @param data Pointer to the first byte
+         * @param size Number of bytes
+         */
+        void write(const char* data, std::size_t size);
+        /**
+         * @brief Compress everything written so far and end the gzip stream
+         *
+         */
+        void finish(void);
+};
+
+#endif // COMPRESSOR_H
\ No newline at end of file
@@ -0,0 +1,198 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "decompressor.h"
+
+#include <climits>
+#include <stdexcept>
+
+/**
+ * @brief Initialize zlib
+ *
+ * @param fname Filename, used in error messages
+ */
+Decompressor::Decompressor(const std::string& fname) :
+    filename(fname),    // Path to the file
+    stream(),           // Initialized below
+    input(nullptr),     // No data yet
+    inputSize(0),       // No data yet
+    finished(false)     // Set at the end of the last member
+{
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    stream.next_in = Z_NULL;
+    stream.avail_in = 0;
+
+    // 16 selects the gzip format instead of zlib
+    if(inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK)
+        throw std::runtime_error("could not initialize decompression of " + fname);
+}
+
+/**
+ * @brief Release the state of zlib
+ *
+ */
+Decompressor::~Decompressor(void)
+{
+    inflateEnd(&stream);
+}
+
+/**
+ * @brief Check if the data starts with the gzip magic bytes
+ *
+ * @param data Beginning of the data
+ * @param size Size of the data in bytes
+ * @return true if the data is compressed with gzip, false otherwise
+ */
+bool Decompressor::isGzip(const char* data, std::size_t size)
+{
+    return size >= 2 &&
+           static_cast<unsigned char>(data[0]) == 0x1f &&
+           static_cast<unsigned char>(data[1]) == 0x8b;
+}
+
+/**
+ * @brief Check if the data starts with the zstd magic bytes
+ *
+ * @param data Beginning of the data
+ * @param size Size of the data in bytes
+ * @return true if the data is compressed with zstd, false otherwise
+ */
+bool Decompressor::isZstd(const char* data, std::size_t size)
+{
+    return size >= 4 &&
+           static_cast<unsigned char>(data[0]) == 0x28 &&
+           static_cast<unsigned char>(data[1]) == 0xb5 &&
+           static_cast<unsigned char>(data[2]) == 0x2f &&
+           static_cast<unsigned char>(data[3]) == 0xfd;
+}
+
+/**
+ * @brief Estimate the size of decompressed gzip data from the trailer.
+ * The trailer holds the size of the last member modulo 2^32, which
+ * is exact for files of one member smaller than 4 GiB
+ *
+ * @param data Compressed data
+ * @param size Size of the data in bytes
+ * @return Expected size in bytes, at least the compressed size
+ */
+std::size_t Decompressor::getSizeHint(const char* data, std::size_t size)
+{
+    // Header and trailer of a member take 18 bytes
+    if(size < 18) return size;
+
+    const unsigned char* trailer = reinterpret_cast<const unsigned char*>(data + size - 4);
+    const std::size_t hint = static_cast<std::size_t>(trailer[0]) |
+                             static_cast<std::size_t>(trailer[1]) << 8 |
+                             static_cast<std::size_t>(trailer[2]) << 16 |
+                             static_cast<std::size_t>(trailer[3]) << 24;
+
+    // Deflate cannot shrink data more than about 1032 times,
+    // so larger sizes come from damaged files
+    if(hint < size || hint / 1032 > size) return size;
+
+    return hint;
+}
+
+/**
+ * @brief Set the next part of compressed data. The data
+ * must stay valid until it is consumed
+ *
+ * @param data Compressed data
+ * @param size Size of the data in bytes
+ */
+void Decompressor::setInput(const char* data, std::size_t size)
+{
+    input = data;
+    inputSize = size;
+}
+
+/**
+ * @brief Check if all compressed data is consumed
+ *
+ * @return true if the next part of data is needed, false otherwise
+ */
+bool Decompressor::needsInput(void) const
+{
+    return stream.avail_in == 0 && inputSize == 0;
+}
+
+/**
+ * @brief Decompress as much data as fits into the output
+ *
+ * @param out Output buffer
+ * @param capacity Size of the output buffer in bytes
+ * @return Number of decompressed bytes
+ */
+std::size_t Decompressor::decompress(char* out, std::size_t capacity)
+{
+    // zlib counts bytes in unsigned int
+    if(capacity > UINT_MAX) capacity = UINT_MAX;
+
+    stream.next_out = reinterpret_cast<Bytef*>(out);
+    stream.avail_out = static_cast<uInt>(capacity);
+
+    while(stream.avail_out > 0)
+    {
+        if(stream.avail_in == 0)
+        {
+            if(inputSize == 0) break;
+
+            const std::size_t part = inputSize > UINT_MAX ? UINT_MAX : inputSize;
+
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input));
+            stream.avail_in = static_cast<uInt>(part);
+            input += part;
+            inputSize -= part;
+        }
+
+        // Data after the end of a member is the next member
+        if(finished)
+        {
+            if(inflateReset(&stream) != Z_OK)
+                throw std::runtime_error("could not decompress " + filename);
+
+            finished = false;
+        }
+
+        const int result = inflate(&stream, Z_NO_FLUSH);
+
+        if(result == Z_STREAM_END)
+            finished = true;
+        else if(result != Z_OK && result != Z_BUF_ERROR)
+            throw std::runtime_error("could not decompress " + filename);
+    }
+
+    return capacity - stream.avail_out;
+}
+
+/**
+ * @brief Check if the compressed data ended properly
+ *
+ * @return true if the last gzip member ended, false otherwise
+ */
+bool Decompressor::isFinished(void) const
+{
+    return finished;
+}
\ No newline at end of file
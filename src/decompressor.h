@@ -0,0 +1,142 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef DECOMPRESSOR_H
+#define DECOMPRESSOR_H
+
+#include <cstddef>
+#include <string>
+
+#include <zlib.h>
+
+/**
+ * @brief Class that decompresses gzip data in parts, so that
+ * compressed files can be read without temporary copies.
+ * Files that consist of several gzip members are decompressed
+ * as a whole, the same way as gzip does it
+ *
+ */
+class Decompressor
+{
+    private:
+        /**
+         * @brief Path to the file, used in error messages
+         *
+         */
+        std::string filename;
+        /**
+         * @brief State of zlib
+         *
+         */
+        z_stream stream;
+        /**
+         * @brief Compressed data that is not passed to zlib yet
+         *
+         */
+        const char* input;
+        /**
+         * @brief Size of the compressed data that is not passed to zlib yet
+         *
+         */
+        std::size_t inputSize;
+        /**
+         * @brief Whether the last gzip member ended
+         *
+         */
+        bool finished;
+
+    public:
+        /**
+         * @brief Initialize zlib
+         *
+         * @param fname Filename, used in error messages
+         */
+        explicit Decompressor(const std::string& fname);
+        /**
+         * @brief Release the state of zlib
+         *
+         */
+        ~Decompressor(void);
+        /**
+         * @brief State of zlib cannot be copied
+         *
+         */
+        Decompressor(const Decompressor&) = delete;
+        Decompressor& operator=(const Decompressor&) = delete;
+        /**
+         * @brief Check if the data starts with the gzip magic bytes
+         *
+         * @param data Beginning of the data
+         * @param size Size of the data in bytes
+         * @return true if the data is compressed with gzip, false otherwise
+         */
+        static bool isGzip(const char* data, std::size_t size);
+        /**
+         * @brief Check if the data starts with the zstd magic bytes
+         *
+         * @param data Beginning of the data
+         * @param size Size of the data in bytes
+         * @return true if the data is compressed with zstd, false otherwise
+         */
+        static bool isZstd(const char* data, std::size_t size);
+        /**
+         * @brief Estimate the size of decompressed gzip data from the trailer.
+         * The trailer holds the size of the last member modulo 2^32, which
+         * is exact for files of one member smaller than 4 GiB
+         *
+         * @param data Compressed data
+         * @param size Size of the data in bytes
+         * @return Expected size in bytes, at least the compressed size
+         */
+        static std::size_t getSizeHint(const char* data, std::size_t size);
+        /**
+         * @brief Set the next part of compressed data. The data
+         * must stay valid until it is consumed
+         *
+         * @param data Compressed data
+         * @param size Size of the data in bytes
+         */
+        void setInput(const char* data, std::size_t size);
+        /**
+         * @brief Check if all compressed data is consumed
+         *
+         * @return true if the next part of data is needed, false otherwise
+         */
+        bool needsInput(void) const;
+        /**
+         * @brief Decompress as much data as fits into the output
+         *
+         * @param out Output buffer
+         * @param capacity Size of the output buffer in bytes
+         * @return Number of decompressed bytes
+         */
+        std::size_t decompress(char* out, std::size_t capacity);
+        /**
+         * @brief Check if the compressed data ended properly
+         *
+         * @return true if the last gzip member ended, false otherwise
+         */
+        bool isFinished(void) const;
+};
+
+#endif // DECOMPRESSOR_H
\ No newline at end of file
@@ -25,10 +25,9 @@
 
 #include <algorithm>
 #include <iostream>
-#include <sstream>
+#include <utility>
 
-#include "file_handler.h"
-#include "file_helper.h"
+#include "diff_engine.h"
 
 // For compatibility with MSVC
 #ifdef min
@@ -38,33 +37,35 @@
 /**
  * @brief Initialize parameters with specified values
  *
- * @param original Lines from the original file
- * @param modified Lines from the modified file
- * @param originalFilename Name of the original file
- * @param modifiedFilename Name of the modified file
+ * @param originalFile Original file
+ * @param modifiedFile Modified file
  * @param options Program options
  */
-Diff::Diff(std::vector<std::string>& original,
-           std::vector<std::string>& modified,
-           const std::string& originalFilename,
-           const std::string& modifiedFilename,
+Diff::Diff(const MappedFile& originalFile,
+           const MappedFile& modifiedFile,
            Options& options) :
-           original(original),
-           modified(modified),
-           originalFilename(originalFilename),
-           modifiedFilename(modifiedFilename),
+           originalFile(originalFile),
+           modifiedFile(modifiedFile),
+           original(originalFile.getLines()),
+           modified(modifiedFile.getLines()),
            options(options),
+           lineTable(),
+           originalIds(),
+           modifiedIds(),
+           removed(),
+           inserted(),
            N(original.size()),
            M(modified.size()),
            MAX(N + M) { }
 
 /**
- * @brief Calculate the difference between two sequences.
- * Based on 'An O(ND) Difference Algorithm' by Eugene W. Myers
- * http://www.xmailserver.org/diff2.pdf
+ * @brief Calculate the difference between two sequences using
+ * the original implementation that keeps history of changes for
+ * each diagonal. It requires O((N+M)*D) memory and is kept only
+ * for comparison with the default algorithm
  *
  */
-void Diff::calculate(void)
+void Diff::calculateLegacy(void)
 {
     // Vector for storing furthest-reaching matching points
     // along diagonals in the edit graph
@@ -119,7 +120,7 @@ void Diff::calculate(void)
             }
 
             // Add all unchanged lines to the history
-            while(x < N && y < M && original[x] == modified[y])
+            while(x < N && y < M && isEqual(x, y))
             {
                 x++;
                 y++;
@@ -133,8 +134,19 @@ void Diff::calculate(void)
             // Check if the end of both sequences is reached
             if(x >= N && y >= M)
             {
-                // Save history and stop
-                items = history;
+                // Save history as the edit script and stop
+                x = 0;
+                y = 0;
+                script.clear();
+
+                for(const DiffItem& item : history)
+                {
+                    script.append(item.getChange(), x, y, 1);
+
+                    if(item.getChange() != Change::Insert) x++;
+                    if(item.getChange() != Change::Remove) y++;
+                }
+
                 return;
             }
             else
@@ -150,71 +162,381 @@ void Diff::calculate(void)
     throw std::runtime_error("could not find edit script");
 }
 
+/**
+ * @brief Compare lines of both files. The last line that does not
+ * end with a new line differs from any line that does
+ *
+ * @param x Index of the line in the original file
+ * @param y Index of the line in the modified file
+ * @return true if lines are equal, false otherwise
+ */
+bool Diff::isEqual(int x, int y) const
+{
+    return original[x] == modified[y] &&
+           (x == N - 1 && !originalFile.hasEndingNewLine()) ==
+           (y == M - 1 && !modifiedFile.hasEndingNewLine());
+}
+
+/**
+ * @brief Narrow the ranges of both files by skipping
+ * unchanged lines at their start and end
+ *
+ * @param aLo Start of the range in the original file
+ * @param aHi End of the range in the original file
+ * @param bLo Start of the range in the modified file
+ * @param bHi End of the range in the modified file
+ */
+void Diff::trimCommonLines(int& aLo, int& aHi, int& bLo, int& bHi) const
+{
+    // Skip common head
+    while(aLo < aHi && bLo < bHi && isEqual(aLo, bLo))
+    {
+        aLo++;
+        bLo++;
+    }
+
+    // Skip common tail
+    while(aLo < aHi && bLo < bHi && isEqual(aHi - 1, bHi - 1))
+    {
+        aHi--;
+        bHi--;
+    }
+}
+
+/**
+ * @brief Build the edit script from flags of removed and inserted lines
+ *
+ * @param removed Flags of removed lines in the original file
+ * @param inserted Flags of inserted lines in the modified file
+ */
+void Diff::buildScript(const std::vector<char>& removed,
+                       const std::vector<char>& inserted)
+{
+    int x = 0, y = 0;
+
+    script.clear();
+
+    while(x < N || y < M)
+    {
+        if(x < N && removed[x]) // Line was removed
+        {
+            script.append(Change::Remove, x, y, 1);
+            x++;
+        }
+        else if(y < M && inserted[y]) // Line was inserted
+        {
+            script.append(Change::Insert, x, y, 1);
+            y++;
+        }
+        else // Unchanged line
+        {
+            script.append(Change::Equal, x, y, 1);
+            x++;
+            y++;
+        }
+    }
+}
+
+/**
+ * @brief Calculate the difference between two sequences
+ * using the algorithm specified in options
+ *
+ */
+void Diff::calculate(void)
+{
+    if(options.getAlgorithm() == Algorithm::Legacy)
+    {
+        calculateLegacy();
+        return;
+    }
+
+    // Flags of changed lines in both files. Lines outside
+    // of the searched ranges stay unchanged
+    removed.assign(N, 0);
+    inserted.assign(M, 0);
+
+    // Ranges of lines that differ between files
+    int aLo = 0, aHi = N, bLo = 0, bHi = M;
+
+    // Most changes affect only a small part of the file,
+    // so the search is done only between common head and tail
+    trimCommonLines(aLo, aHi, bLo, bHi);
+
+    // Lines are replaced with IDs, so the search compares integers.
+    // Only lines within the ranges get an ID. Hashes of lines were
+    // calculated when files were loaded
+    lineTable.clear();
+    originalIds.assign(N, 0);
+    modifiedIds.assign(M, 0);
+    lineTable.add(original, originalFile.getHashes(), aLo, aHi, originalIds);
+    lineTable.add(modified, modifiedFile.getHashes(), bLo, bHi, modifiedIds);
+
+    // The last line without a new line cannot match any other line.
+    // If both files end with the same such line, it is already trimmed
+    if(aHi == N && N > 0 && !originalFile.hasEndingNewLine())
+        originalIds[N - 1] = lineTable.addDistinct(original[N - 1]);
+
+    if(bHi == M && M > 0 && !modifiedFile.hasEndingNewLine())
+        modifiedIds[M - 1] = lineTable.addDistinct(modified[M - 1]);
+
+    // Search for the shortest edit script between ranges
+    DiffEngine engine(originalIds, modifiedIds, lineTable.size(), options);
+    engine.calculate(aLo, aHi, bLo, bHi, removed, inserted);
+
+    buildScript(removed, inserted);
+}
+
+/**
+ * @brief Take the edit script from the cache, or calculate it
+ * and add it to the cache
+ *
+ * @param cache Cache of edit scripts
+ * @return true if the edit script was taken from the cache, false otherwise
+ */
+bool Diff::calculate(ResultCache& cache)
+{
+    const std::string key = cache.getKey(originalFile, modifiedFile, options);
+
+    if(cache.load(key, N, M, script)) return true;
+
+    calculate();
+    cache.store(key, N, M, script);
+
+    return false;
+}
+
+/**
+ * @brief Calculate the difference by updating the edit script of the
+ * previous modified file. Lines between the last equal line before the
+ * first change and the first equal line after the last change are compared
+ * again, the rest of the previous script is kept
+ *
+ * @param previous State of the previous run with the same original file
+ * @return Number of lines in both files that were compared again
+ */
+std::size_t Diff::calculate(const DiffState& previous)
+{
+    // The legacy algorithm cannot compare a part of files
+    if(options.getAlgorithm() == Algorithm::Legacy)
+    {
+        calculateLegacy();
+        return N + M;
+    }
+
+    const std::vector<std::uint64_t>& oldHashes = previous.getModifiedHashes();
+    const std::vector<std::uint64_t>& newHashes = modifiedFile.getHashes();
+    const int oldM = static_cast<int>(oldHashes.size());
+    const int delta = M - oldM;
+    int head = 0, tail = 0;
+
+    // Find lines that are the same at the start and the end of both versions
+    // of the modified file. The last line is the same only if both versions
+    // end the same way, which only the end checks. The start stops before
+    // the last line of a version that does not end with a new line
+    const int oldLimit = previous.getModifiedEndingNewLine() ? oldM : oldM - 1;
+    const int newLimit = modifiedFile.hasEndingNewLine() ? M : M - 1;
+
+    while(head < oldLimit && head < newLimit &&
+          previous.isSameLine(head, newHashes[head], modified[head]))
+        head++;
+
+    if(previous.getModifiedEndingNewLine() == modifiedFile.hasEndingNewLine())
+    {
+        while(tail < oldM - head && tail < M - head &&
+              previous.isSameLine(oldM - 1 - tail, newHashes[M - 1 - tail], modified[M - 1 - tail]))
+            tail++;
+    }
+
+    // Move both ends of the changed part to equal lines of the previous
+    // script. The script up to the start and from the end stays valid
+    int aLo = 0, aHi = N, bLo = 0, bHi = oldM;
+    int k;
+
+    for(const EditRun& run : previous.getScript().getRuns())
+    {
+        if(run.getChange() != Change::Equal) continue;
+
+        const int lineOld = run.getLineOld();
+        const int lineNew = run.getLineNew();
+        const int length = run.getLength();
+
+        // Last point after an equal line that does not pass the first change
+        if(lineNew < head)
+        {
+            k = std::min(length, head - lineNew);
+            aLo = lineOld + k;
+            bLo = lineNew + k;
+        }
+
+        // First point before an equal line that does not precede the last change
+        if(lineNew + length > oldM - tail)
+        {
+            k = std::max(0, oldM - tail - lineNew);
+            aHi = lineOld + k;
+            bHi = lineNew + k;
+            break;
+        }
+    }
+
+    // Changes outside of the part are taken from the previous script.
+    // Lines after the part are shifted by the change of the file length
+    removed.assign(N, 0);
+    inserted.assign(M, 0);
+
+    for(const EditRun& run : previous.getScript().getRuns())
+    {
+        const int first = (run.getChange() == Change::Remove) ? run.getLineOld() : run.getLineNew();
+        const int last = first + static_cast<int>(run.getLength());
+
+        if(run.getChange() == Change::Remove)
+        {
+            for(k = first; k < std::min(last, aLo); k++) removed[k] = 1;
+            for(k = std::max(first, aHi); k < last; k++) removed[k] = 1;
+        }
+        else if(run.getChange() == Change::Insert)
+        {
+            for(k = first; k < std::min(last, bLo); k++) inserted[k] = 1;
+            for(k = std::max(first, bHi); k < last; k++) inserted[k + delta] = 1;
+        }
+    }
+
+    bHi += delta;
+
+    const int compared = (aHi - aLo) + (bHi - bLo);
+
+    trimCommonLines(aLo, aHi, bLo, bHi);
+
+    // Only lines within the part get an ID
+    lineTable.clear();
+    originalIds.assign(N, 0);
+    modifiedIds.assign(M, 0);
+    lineTable.add(original, originalFile.getHashes(), aLo, aHi, originalIds);
+    lineTable.add(modified, modifiedFile.getHashes(), bLo, bHi, modifiedIds);
+
+    // The last line without a new line cannot match any other line
+    if(aHi == N && N > 0 && !originalFile.hasEndingNewLine())
+        originalIds[N - 1] = lineTable.addDistinct(original[N - 1]);
+
+    if(bHi == M && M > 0 && !modifiedFile.hasEndingNewLine())
+        modifiedIds[M - 1] = lineTable.addDistinct(modified[M - 1]);
+
+    DiffEngine engine(originalIds, modifiedIds, lineTable.size(), options);
+    engine.calculate(aLo, aHi, bLo, bHi, removed, inserted);
+
+    buildScript(removed, inserted);
+
+    return compared;
+}
+
+/**
+ * @brief Exchange the memory used by the calculation with the storage.
+ * Called before the calculation to reuse memory of a previous
+ * comparison and after the output to give it back
+ *
+ * @param storage Storage of a previous comparison
+ */
+void Diff::swapStorage(Storage& storage)
+{
+    std::swap(lineTable, storage.lineTable);
+    originalIds.swap(storage.originalIds);
+    modifiedIds.swap(storage.modifiedIds);
+    removed.swap(storage.removed);
+    inserted.swap(storage.inserted);
+    std::swap(script, storage.script);
+}
+
+/**
+ * @brief Get the calculated edit script
+ *
+ * @return Edit script
+ */
+const EditScript& Diff::getScript(void) const
+{
+    return this->script;
+}
+
 /**
  * @brief Generate output of the hunk and write it to stream
  *
- * @param os Output stream
+ * @param os Output sink
  * @param ch Smart pointer to the ColorHandler instance
- * @param start Index of the start of the hunk
- * @param end Index of the end of the hunk
- * @param linesChangedOld Number of lines changed in the original file
- * @param linesChangedNew Number of lines changed in the modified file
+ * @param start Iterator at the first line of the hunk
+ * @param end Iterator past the last line of the hunk
+ * @param lineOld Position of the hunk in the original file
+ * @param linesOld Number of lines in the original file the hunk applies to
+ * @param lineNew Position of the hunk in the modified file
+ * @param linesNew Number of lines in the modified file the hunk applies to
  */
-void Diff::generateHunk(std::ostream& os,
+void Diff::generateHunk(OutputSink& os,
                         std::unique_ptr<ColorHandler>& ch,
-                        unsigned short start,
-                        unsigned short end,
-                        unsigned short linesChangedOld,
-                        unsigned short linesChangedNew) const
+                        EditScript::const_iterator start,
+                        EditScript::const_iterator end,
+                        unsigned int lineOld,
+                        unsigned int linesOld,
+                        unsigned int lineNew,
+                        unsigned int linesNew) const
 {
     // Whether to use colors (only while printing to console)
     bool useColors = options.getUseColors() && !options.getOutputToFile();
 
-    // Output range information
+    // Output range information. An empty range refers
+    // to the line right before the hunk
 
     if(useColors) ch->setColor(Color::Magenta);
 
     os << "@@ -"
-        << items[start].getLineOld() + 1 // Starting line in the original file
+        << lineOld + (linesOld > 0 ? 1 : 0) // Starting line in the original file
         << ','
-        << linesChangedOld // Number of lines in the original file the hunk
-        << " +"            //                                    applies to
-        << items[start].getLineNew() + 1 // Starting line in the modified file
+        << linesOld
+        << " +"
+        << lineNew + (linesNew > 0 ? 1 : 0) // Starting line in the modified file
         << ','
-        << linesChangedNew // Number of lines in the modified file the hunk
-        << " @@\n";        //                                    applies to
+        << linesNew
+        << " @@\n";
 
     if(useColors) ch->resetColor();
 
     // Output the hunk
 
-    for(int i = start; i <= end; i++)
+    for(EditScript::const_iterator it = start; it != end; ++it)
     {
-        if(items[i].getChange() == Change::Remove) // Line is removed
+        const DiffItem item = *it;
+
+        if(item.getChange() == Change::Remove) // Line is removed
         {
             if(useColors) ch->setColor(Color::Red);
-            os << '-' << original[items[i].getLineOld()] << '\n';
+            os << '-' << original[item.getLineOld()] << '\n';
             if(useColors) ch->resetColor();
         }
-        else if(items[i].getChange() == Change::Insert) // Line is inserted
+        else if(item.getChange() == Change::Insert) // Line is inserted
         {
             if(useColors) ch->setColor(Color::Green);
-            os << '+' << modified[items[i].getLineNew()] << '\n';
+            os << '+' << modified[item.getLineNew()] << '\n';
             if(useColors) ch->resetColor();
         }
         else // Unchanged line
         {
-            os << ' ' << original[items[i].getLineOld()] << '\n';
+            os << ' ' << original[item.getLineOld()] << '\n';
         }
+
+        // Display a message after the last line of a file
+        // that does not end with a new line
+        if((item.getChange() != Change::Insert &&
+            item.getLineOld() + 1 == original.size() &&
+            !originalFile.hasEndingNewLine()) ||
+           (item.getChange() == Change::Insert &&
+            item.getLineNew() + 1 == modified.size() &&
+            !modifiedFile.hasEndingNewLine()))
+            os << "\\ No newline at end of file\n";
     }
 }
 
 /**
- * @brief Generate output in unified format and write it to stream
+ * @brief Generate output in unified format and write it to sink
  *
- * @param os Output stream
+ * @param os Output sink
  */
-void Diff::generateUnidiff(std::ostream& os) const
+void Diff::generateUnidiff(OutputSink& os) const
 {
     // Create a smart pointer to the ColorHandler class
     std::unique_ptr<ColorHandler> ch = nullptr;
@@ -224,10 +546,12 @@ void Diff::generateUnidiff(std::ostream& os) const
     try
     {
         // Create an instance of ColorHandler class
-        // and assign it to the smart pointer
-        ch = std::unique_ptr<ColorHandler>(
-            new ColorHandler(options.getForceAnsiCodes())
-        );
+        // and assign it to the smart pointer. Colors are
+        // not touched at all when they are not used
+        if(useColors)
+            ch = std::unique_ptr<ColorHandler>(
+                new ColorHandler(os, options.getForceAnsiCodes())
+            );
     }
     catch(std::exception& e)
     {
@@ -236,183 +560,81 @@ void Diff::generateUnidiff(std::ostream& os) const
         return;
     }
 
-    // Number of diff items
-    const unsigned int itemCount = items.size();
+    // Dates were taken when files were opened
+    DateTime dtOriginal = originalFile.getLastModified();
+    DateTime dtModified = modifiedFile.getLastModified();
+
+    // Output the header
+
+    if(useColors) ch->setColor(Color::Red);
+    os << "--- " << originalFile.getFilename() << '\t' << dtOriginal.format() << '\n';
+    if(useColors) ch->setColor(Color::Green);
+    os << "+++ " << modifiedFile.getFilename() << '\t' << dtModified.format() << '\n';
+    if(useColors) ch->resetColor();
+
+    // Runs of the edit script
+    const std::vector<EditRun>& runs = script.getRuns();
+    // Number of runs
+    const std::size_t runCount = runs.size();
+    // Number of context lines
+    const unsigned int context = options.getContextLines();
 
     /*
      * A hunk is a block of consecutive changed lines, along with a
      * specified number of unchanged lines before and after it for context.
+     * Hunks separated by no more than twice the number of context lines
+     * are merged into one hunk.
     */
 
-    bool isHunk = false; // Is inside a hunk
-    unsigned short hunkStart = 0; // Index where the hunk starts
-    unsigned short hunkEnd = 0; // Index where the hunk ends
-    unsigned short linesCount = 0; // Number of lines from the start of the
-                                   // sequence or the end of the previous hunk
-    unsigned short equalsCount = 0; // Number of unchanged lines
-    unsigned short removesCount = 0; // Number of removed lines
-    unsigned short insertsCount = 0; // Number of inserted lines
-    unsigned int end; // Prediction of the index of the last item in the hunk
-    unsigned int i, j; // Loop counters
-
-    DateTime dtOriginal;
-    DateTime dtModified;
-
-    try
-    {
-        // Get last modification date of the original file
-        FileHelper::getLastModifiedDate(originalFilename, dtOriginal);
+    std::size_t first = 0; // Index of the first changed run in the hunk
+    std::size_t last; // Index of the last changed run in the hunk
+    unsigned int before; // Number of context lines before the hunk
+    unsigned int after; // Number of context lines after the hunk
+    unsigned int linesOld; // Number of lines in the original file
+    unsigned int linesNew; // Number of lines in the modified file
+    std::size_t i; // Loop counter
 
-        // Get last modification date of the original file
-        FileHelper::getLastModifiedDate(modifiedFilename, dtModified);
-    }
-    catch(std::exception& e)
+    while(true)
     {
-        std::cerr << "Error: " << e.what() << '\n';
-        return;
-    }
-
-    // Output the header
+        // Find the next changed run
+        while(first < runCount && runs[first].getChange() == Change::Equal)
+            first++;
 
-    if(useColors) ch->setColor(Color::Red);
-    os << "--- " << originalFilename << '\t' << dtOriginal.format() << '\n';
-    if(useColors) ch->setColor(Color::Green);
-    os << "+++ " << modifiedFilename << '\t' << dtModified.format() << '\n';
-    if(useColors) ch->resetColor();
+        if(first == runCount) break;
 
-    // Iterate through all diff items
-    for(i = 0, j = 1; i < itemCount; i++, j++)
-    {
-        // If not inside a hunk
-        if(!isHunk)
+        // Extend the hunk while the next change is close enough
+        for(last = first; last + 1 < runCount; last++)
         {
-            if(items[i].getChange() != Change::Equal) // Changed line
-            {
-                isHunk = true;
-                hunkEnd = i - 1;
-            }
-            else // Unchanged line
-            {
-                // If at the start of the sequence or
-                // the previous hunk just ended,
-                // count unchanged lines but only up to
-                // the specified amount needed for context
-                if(linesCount >= options.getContextLines())
-                    hunkStart++;
-                else
-                    equalsCount++;
-
-                linesCount++;
-            }
+            if(runs[last + 1].getChange() == Change::Equal &&
+               (last + 2 == runCount || runs[last + 1].getLength() > 2 * context))
+                break;
         }
 
-        // If inside a hunk
-        if(isHunk)
-        {
-            if(items[i].getChange() == Change::Insert) // Inserted line
-            {
-                hunkEnd++; // Shift the position of the end of the hunk
-                insertsCount++;
-            }
-            else if(items[i].getChange() == Change::Remove) // Removed line
-            {
-                hunkEnd++; // Shift the position of the end of the hunk
-                removesCount++;
-            }
-            else // Unchanged line
-            {
-                // Mark the end of the hunk
-                // (not including unchanged lines after)
-                isHunk = false;
-                linesCount = 0;
-
-                // Calculate the end of the hunk.
-                // Either up to n or to the last item,
-                // where n is the number of context lines
-                end = std::min(hunkEnd + options.getContextLines() + 1, itemCount);
-
-                // Check n lines ahead
-                for(j = hunkEnd + 1; j < end; j++)
-                {
-                    // If unchanged line found
-                    if(items[j].getChange() != Change::Equal)
-                    {
-                        // Continue the hunk
-                        isHunk = true;
-                        break;
-                    }
-                    else
-                    {
-                        equalsCount++;
-                        hunkEnd++; // Shift the index of the end of the hunk
-                    }
-                }
+        // Unchanged lines before and after the hunk
+        before = (first > 0) ? std::min(context, runs[first - 1].getLength()) : 0;
+        after = (last + 1 < runCount) ? std::min(context, runs[last + 1].getLength()) : 0;
 
-                // Skip checked elements
-                i = j - 1;
+        // Count lines in both files the hunk applies to
+        linesOld = before + after;
+        linesNew = before + after;
 
-                // If the end of the sequence is reached
-                if(j == itemCount - 1)
-                {
-                    // Output the hunk
-                    generateHunk(os, ch, hunkStart, hunkEnd,
-                        equalsCount + removesCount,
-                        equalsCount + insertsCount);
-
-                    break;
-                }
-
-                // Skip the rest of the loop iteration if still inside a hunk
-                if(isHunk) continue;
-
-                // Check the next n + 1 lines to detect if the next hunk
-                // goes right after the current one. In this case they will
-                // be merged into one hunk.
-                end = std::min(end + options.getContextLines(), itemCount);
-
-                for(j = i; j < end; j++)
-                {
-                    if(items[j].getChange() != Change::Equal) // Changed line detected
-                        break;
-
-                    // If next n lines were checked, check the next line.
-                    // If the next line is changed, continue the hunk
-                    if(j == end - 1 && j + 1 < itemCount &&
-                       items[j + 1].getChange() != Change::Equal)
-                        isHunk = true;
-                }
+        for(i = first; i <= last; i++)
+        {
+            linesOld += runs[i].getLengthOld();
+            linesNew += runs[i].getLengthNew();
+        }
 
-                // Skip the rest of the loop iteration if still inside a hunk
-                if(isHunk) continue;
-
-                // Output the hunk
-                generateHunk(os, ch, hunkStart, hunkEnd,
-                    equalsCount + removesCount,
-                    equalsCount + insertsCount);
-
-                linesCount = 0;
-                equalsCount = 0;
-                insertsCount = 0;
-                removesCount = 0;
-                hunkStart = hunkEnd + 1;
-                i = hunkStart - 1;
-                j = i + 1;
-            }
+        // Output the hunk
+        generateHunk(os, ch,
+            (before > 0) ?
+                script.iteratorAt(first - 1, runs[first - 1].getLength() - before) :
+                script.iteratorAt(first, 0),
+            script.iteratorAt(last + 1, after),
+            runs[first].getLineOld() - before, linesOld,
+            runs[first].getLineNew() - before, linesNew);
 
-            // If the end of the sequence is reached and hunk isn't printed yet
-            if(i == itemCount - 1 && hunkStart < itemCount)
-            {
-                // Output the hunk
-                generateHunk(os, ch, hunkStart, hunkEnd,
-                    equalsCount + removesCount,
-                    equalsCount + insertsCount);
-            }
-        }
+        first = last + 1;
     }
-
-    // Display a message if a modified file does not end with a new line
-    if(!FileHelper::hasEndingNewLine(modifiedFilename))
-        os << "\\ No newline at end of file\n";
 }
 
 /**
@@ -423,16 +645,58 @@ void Diff::print(void) const
 {
     if(options.getOutputToFile()) // Write to file
     {
-        // Redirect unidiff output to stringstream
-        std::stringstream ss;
-        generateUnidiff(ss);
-        // Create output file stream
-        FileHandler outputFile(options.getOutputFilePath(), std::ios::out);
-        // Convert stringstream output to string and write it to file
-        outputFile.write(ss.str());
+        // Output is written to the file as the buffer fills up
+        // Compression runs on another thread when more threads are allowed
+        OutputSink outputFile(options.getOutputFilePath(), options.getThreadCount() > 1);
+        generateUnidiff(outputFile);
+        outputFile.finish();
     }
     else // Print to console
     {
-        generateUnidiff(std::cout);
+        OutputSink console;
+        generateUnidiff(console);
+        console.finish();
     }
+}
+
+/**
+ * @brief Write the difference to the output sink
+ *
+ * @param os Output sink
+ */
+void Diff::write(OutputSink& os) const
+{
+    generateUnidiff(os);
+}
+
+/**
+ * @brief Report that binary files differ instead of printing
+ * the difference, the same way as GNU diff does it
+ *
+ */
+void Diff::printBinary(void) const
+{
+    if(options.getOutputToFile()) // Write to file
+    {
+        OutputSink outputFile(options.getOutputFilePath(), options.getThreadCount() > 1);
+        writeBinary(outputFile);
+        outputFile.finish();
+    }
+    else // Print to console
+    {
+        OutputSink console;
+        writeBinary(console);
+        console.finish();
+    }
+}
+
+/**
+ * @brief Write the message that binary files differ to the output sink
+ *
+ * @param os Output sink
+ */
+void Diff::writeBinary(OutputSink& os) const
+{
+    os << "Binary files " << originalFile.getFilename() << " and "
+       << modifiedFile.getFilename() << " differ\n";
 }
\ No newline at end of file
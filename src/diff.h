@@ -24,14 +24,21 @@
 #ifndef DIFF_H
 #define DIFF_H
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
-#include <ostream>
 #include <string>
 #include <vector>
 
 #include "color_handler.h"
-#include "diff_item.h"
+#include "diff_state.h"
+#include "edit_script.h"
+#include "line_table.h"
+#include "line_view.h"
+#include "mapped_file.h"
 #include "options.h"
+#include "output_sink.h"
+#include "result_cache.h"
 
 /**
  * @brief Class for calculating and printing difference between files
@@ -41,35 +48,60 @@ class Diff
 {
     private:
         /**
-         * @brief Collection of calculated differences
+         * @brief Calculated edit script
          *
          */
-        std::vector<DiffItem> items;
+        EditScript script;
         /**
-         * @brief Lines from the original file
+         * @brief Original file
          *
          */
-        std::vector<std::string>& original;
+        const MappedFile& originalFile;
         /**
-         * @brief Lines from the modified file
+         * @brief Modified file
          *
          */
-        std::vector<std::string>& modified;
+        const MappedFile& modifiedFile;
         /**
-         * @brief Name of the original file
+         * @brief Lines from the original file
          *
          */
-        std::string originalFilename;
+        const std::vector<LineView>& original;
         /**
-         * @brief Name of the modified file
+         * @brief Lines from the modified file
          *
          */
-        std::string modifiedFilename;
+        const std::vector<LineView>& modified;
         /**
          * @brief Program options
          *
          */
         Options& options;
+        /**
+         * @brief Table of unique lines from both files
+         *
+         */
+        LineTable lineTable;
+        /**
+         * @brief IDs of lines from the original file
+         *
+         */
+        std::vector<std::uint32_t> originalIds;
+        /**
+         * @brief IDs of lines from the modified file
+         *
+         */
+        std::vector<std::uint32_t> modifiedIds;
+        /**
+         * @brief Flags of removed lines in the original file
+         *
+         */
+        std::vector<char> removed;
+        /**
+         * @brief Flags of inserted lines in the modified file
+         *
+         */
+        std::vector<char> inserted;
         /**
          * @brief Number of lines in the original file
          *
@@ -85,56 +117,155 @@ class Diff
          *
          */
         const int MAX;
+        /**
+         * @brief Calculate the difference between two sequences using
+         * the original implementation that keeps history of changes for
+         * each diagonal. It requires O((N+M)*D) memory and is kept only
+         * for comparison with the default algorithm
+         *
+         */
+        void calculateLegacy(void);
+        /**
+         * @brief Compare lines of both files. The last line that does not
+         * end with a new line differs from any line that does
+         *
+         * @param x Index of the line in the original file
+         * @param y Index of the line in the modified file
+         * @return true if lines are equal, false otherwise
+         */
+        bool isEqual(int x, int y) const;
+        /**
+         * @brief Narrow the ranges of both files by skipping
+         * unchanged lines at their start and end
+         *
+         * @param aLo Start of the range in the original file
+         * @param aHi End of the range in the original file
+         * @param bLo Start of the range in the modified file
+         * @param bHi End of the range in the modified file
+         */
+        void trimCommonLines(int& aLo, int& aHi, int& bLo, int& bHi) const;
+        /**
+         * @brief Build the edit script from flags of removed and inserted lines
+         *
+         * @param removed Flags of removed lines in the original file
+         * @param inserted Flags of inserted lines in the modified file
+         */
+        void buildScript(const std::vector<char>& removed,
+                         const std::vector<char>& inserted);
         /**
          * @brief Generate output of the hunk and write it to stream
          *
-         * @param os Output stream
+         * @param os Output sink
          * @param ch Smart pointer to the ColorHandler instance
-         * @param start Index of the start of the hunk
-         * @param end Index of the end of the hunk
-         * @param linesChangedOld Number of lines changed in the original file
-         * @param linesChangedNew Number of lines changed in the modified file
+         * @param start Iterator at the first line of the hunk
+         * @param end Iterator past the last line of the hunk
+         * @param lineOld Position of the hunk in the original file
+         * @param linesOld Number of lines in the original file the hunk applies to
+         * @param lineNew Position of the hunk in the modified file
+         * @param linesNew Number of lines in the modified file the hunk applies to
          */
-        void generateHunk(std::ostream& os,
+        void generateHunk(OutputSink& os,
                           std::unique_ptr<ColorHandler>& ch,
-                          unsigned short start,
-                          unsigned short end,
-                          unsigned short linesChangedOld,
-                          unsigned short linesChangedNew) const;
+                          EditScript::const_iterator start,
+                          EditScript::const_iterator end,
+                          unsigned int lineOld,
+                          unsigned int linesOld,
+                          unsigned int lineNew,
+                          unsigned int linesNew) const;
         /**
-         * @brief Generate output in unified format and write it to stream
+         * @brief Generate output in unified format and write it to sink
          *
-         * @param os Output stream
+         * @param os Output sink
          */
-        void generateUnidiff(std::ostream& os) const;
+        void generateUnidiff(OutputSink& os) const;
 
     public:
+        /**
+         * @brief Memory used by the calculation, kept between
+         * comparisons of different files to avoid allocations
+         *
+         */
+        struct Storage
+        {
+            LineTable lineTable;
+            std::vector<std::uint32_t> originalIds;
+            std::vector<std::uint32_t> modifiedIds;
+            std::vector<char> removed;
+            std::vector<char> inserted;
+            EditScript script;
+        };
+
         /**
          * @brief Initialize parameters with specified values
          *
-         * @param original Lines from the original file
-         * @param modified Lines from the modified file
-         * @param originalFilename Name of the original file
-         * @param modifiedFilename Name of the modified file
+         * @param originalFile Original file
+         * @param modifiedFile Modified file
          * @param options Program options
          */
-        Diff(std::vector<std::string>& original,
-             std::vector<std::string>& modified,
-             const std::string& originalFilename,
-             const std::string& modifiedFilename,
+        Diff(const MappedFile& originalFile,
+             const MappedFile& modifiedFile,
              Options& options);
         /**
-         * @brief Calculate the difference between two sequences.
-         * Based on 'An O(ND) Difference Algorithm' by Eugene W. Myers
-         * http://www.xmailserver.org/diff2.pdf
+         * @brief Calculate the difference between two sequences
+         * using the algorithm specified in options
          *
          */
         void calculate(void);
+        /**
+         * @brief Take the edit script from the cache, or calculate it
+         * and add it to the cache
+         *
+         * @param cache Cache of edit scripts
+         * @return true if the edit script was taken from the cache, false otherwise
+         */
+        bool calculate(ResultCache& cache);
+        /**
+         * @brief Calculate the difference by updating the edit script of the
+         * previous modified file. Lines between the last equal line before the
+         * first change and the first equal line after the last change are compared
+         * again, the rest of the previous script is kept
+         *
+         * @param previous State of the previous run with the same original file
+         * @return Number of lines in both files that were compared again
+         */
+        std::size_t calculate(const DiffState& previous);
+        /**
+         * @brief Exchange the memory used by the calculation with the storage.
+         * Called before the calculation to reuse memory of a previous
+         * comparison and after the output to give it back
+         *
+         * @param storage Storage of a previous comparison
+         */
+        void swapStorage(Storage& storage);
+        /**
+         * @brief Get the calculated edit script
+         *
+         * @return Edit script
+         */
+        const EditScript& getScript(void) const;
         /**
          * @brief Print the difference to console or write it to file
          *
          */
         void print(void) const;
+        /**
+         * @brief Write the difference to the output sink
+         *
+         * @param os Output sink
+         */
+        void write(OutputSink& os) const;
+        /**
+         * @brief Report that binary files differ instead of printing
+         * the difference, the same way as GNU diff does it
+         *
+         */
+        void printBinary(void) const;
+        /**
+         * @brief Write the message that binary files differ to the output sink
+         *
+         * @param os Output sink
+         */
+        void writeBinary(OutputSink& os) const;
 };
 
 #endif // DIFF_H
\ No newline at end of file
@@ -0,0 +1,181 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "diff_client.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "diff_server.h"
+
+#if !defined(_WIN32) // POSIX
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif // _WIN32
+
+/**
+ * @brief Initialize parameters with specified values
+ *
+ * @param socketPath Path to the socket of the server
+ */
+DiffClient::DiffClient(const std::string& socketPath) :
+    socketPath(socketPath) { } // Path to the socket of the server
+
+/**
+ * @brief Send the request to the server and wait until it is done
+ *
+ * @param argc Number of command line arguments
+ * @param argv Command line arguments passed to the program
+ * @return Exit code of the request
+ */
+int DiffClient::run(int argc, char* argv[])
+{
+#if defined(_WIN32) // Windows
+    (void)argc;
+    (void)argv;
+    throw std::runtime_error("client mode is not supported on Windows");
+#else // POSIX
+    // Arguments are terminated with null characters
+    std::string data;
+
+    for(int i = 0; i < argc; i++)
+    {
+        data += argv[i];
+        data += '\0';
+    }
+
+    if(data.size() > DiffServer::MAX_REQUEST_SIZE)
+        throw std::invalid_argument("arguments are too long for the server");
+
+    struct sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if(socketPath.size() >= sizeof(address.sun_path))
+        throw std::invalid_argument("path to the socket is too long");
+
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+
+    const int connection = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if(connection == -1)
+        throw std::runtime_error("could not create the socket");
+
+    if(connect(connection, reinterpret_cast<struct sockaddr*>(&address),
+               sizeof(address)) == -1)
+    {
+        close(connection);
+        throw std::runtime_error("could not connect to " + socketPath);
+    }
+
+    const int cwd = open(".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    if(cwd == -1)
+    {
+        close(connection);
+        throw std::runtime_error("could not open the working directory");
+    }
+
+    // The server writes directly to streams of the client
+    const int descriptors[DiffServer::DESCRIPTOR_COUNT] = { cwd, 0, 1, 2 };
+    std::uint32_t length = static_cast<std::uint32_t>(data.size());
+    union
+    {
+        struct cmsghdr header;
+        char data[CMSG_SPACE(sizeof(descriptors))];
+    } control;
+    struct iovec parts[2];
+    struct msghdr message;
+
+    parts[0].iov_base = &length;
+    parts[0].iov_len = sizeof(length);
+    parts[1].iov_base = &data[0];
+    parts[1].iov_len = data.size();
+
+    std::memset(&control, 0, sizeof(control));
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov = parts;
+    message.msg_iovlen = 2;
+    message.msg_control = control.data;
+    message.msg_controllen = sizeof(control.data);
+
+    struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(descriptors));
+    std::memcpy(CMSG_DATA(header), descriptors, sizeof(descriptors));
+
+    ssize_t n;
+
+    do
+    {
+        n = sendmsg(connection, &message, MSG_NOSIGNAL);
+    }
+    while(n == -1 && errno == EINTR);
+
+    // Descriptors are duplicated by the kernel when sent
+    close(cwd);
+
+    // Long requests may be sent in several parts
+    std::size_t sent = (n > 0) ? static_cast<std::size_t>(n) : 0;
+    const std::size_t total = sizeof(length) + data.size();
+
+    while(n != -1 && sent < total)
+    {
+        if(sent < sizeof(length))
+            n = send(connection, reinterpret_cast<char*>(&length) + sent,
+                     sizeof(length) - sent, MSG_NOSIGNAL);
+        else
+            n = send(connection, data.data() + sent - sizeof(length),
+                     total - sent, MSG_NOSIGNAL);
+
+        if(n > 0) sent += n;
+        else if(n == -1 && errno == EINTR) n = 0;
+    }
+
+    if(n == -1)
+    {
+        close(connection);
+        throw std::runtime_error("could not send the request to the server");
+    }
+
+    char status;
+
+    do
+    {
+        n = read(connection, &status, 1);
+    }
+    while(n == -1 && errno == EINTR);
+
+    close(connection);
+
+    if(n != 1)
+        throw std::runtime_error("server closed the connection");
+
+    return static_cast<unsigned char>(status);
+#endif // _WIN32
+}
\ No newline at end of file
@@ -21,56 +21,42 @@
  * SOFTWARE.
  */
 
-#ifndef FILE_HANDLER_H
-#define FILE_HANDLER_H
+#ifndef DIFF_CLIENT_H
+#define DIFF_CLIENT_H
 
-#include <fstream>
 #include <string>
-#include <vector>
 
 /**
- * @brief Class for reading from / writing to file
+ * @brief Client that lets the server calculate the difference.
+ * Command line arguments are sent to the server together with the working
+ * directory and standard streams, so the server writes the output directly
+ * and the result is the same as if the program had run by itself
  *
  */
-class FileHandler
+class DiffClient
 {
     private:
         /**
-         * @brief Input/output file stream
+         * @brief Path to the socket of the server
          *
          */
-        std::fstream fileStream;
+        std::string socketPath;
 
     public:
         /**
-         * @brief Initialize file stream
+         * @brief Initialize parameters with specified values
          *
-         * @param fname Filename
-         * @param mode File mode
+         * @param socketPath Path to the socket of the server
          */
-        FileHandler(const std::string& fname, std::ios_base::openmode mode);
+        explicit DiffClient(const std::string& socketPath);
         /**
-         * @brief Close the file stream
+         * @brief Send the request to the server and wait until it is done
          *
+         * @param argc Number of command line arguments
+         * @param argv Command line arguments passed to the program
+         * @return Exit code of the request
          */
-        ~FileHandler(void);
-        /**
-         * @brief Read text from file
-         *
-         * @return Vector with lines from file
-         */
-        std::vector<std::string> read(void);
-        /**
-         * @brief Write text to file
-         *
-         * @param data Text to be written
-         */
-        void write(const std::string& data);
-        /**
-         * @brief Close file stream
-         *
-         */
-        void close(void);
+        int run(int argc, char* argv[]);
 };
 
-#endif // FILE_HANDLER_H
\ No newline at end of file
+#endif // DIFF_CLIENT_H
\ No newline at end of file
@@ -0,0 +1,247 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "diff_engine.h"
+
+#include <algorithm>
+#include <climits>
+
+#include "bit_parallel_lcs.h"
+#include "histogram_diff.h"
+#include "myers_diff.h"
+#include "patience_diff.h"
+#include "thread_pool.h"
+
+/**
+ * @brief Initialize the engine
+ *
+ * @param original IDs of lines from the original file
+ * @param modified IDs of lines from the modified file
+ * @param idCount Number of distinct IDs in both sequences
+ * @param options Program options
+ */
+DiffEngine::DiffEngine(const std::vector<std::uint32_t>& original,
+                       const std::vector<std::uint32_t>& modified,
+                       std::uint32_t idCount,
+                       const Options& options) :
+    original(original),     // IDs of lines from the original file
+    modified(modified),     // IDs of lines from the modified file
+    idCount(idCount),       // Number of distinct IDs
+    options(options) { }    // Program options
+
+/**
+ * @brief Get the number of steps of the middle snake search after
+ * which the search gives up on the shortest edit script. Like in GNU diff,
+ * the limit grows with the square root of the number of lines
+ *
+ * @param lines Number of lines in both ranges
+ * @return Maximum number of steps
+ */
+int DiffEngine::getCostLimit(int lines) const
+{
+    if(options.getMinimal()) return INT_MAX;
+
+    int limit = 1;
+
+    // Roughly twice the square root of the number of diagonals
+    for(int diagonals = lines + 3; diagonals != 0; diagonals >>= 2)
+        limit <<= 1;
+
+    return std::max(options.getSpeedLargeFiles() ? 256 : 4096, limit);
+}
+
+/**
+ * @brief Calculate the difference between ranges of two sequences
+ * of line IDs using the algorithm specified in options
+ *
+ * @param a IDs of lines from the original file
+ * @param b IDs of lines from the modified file
+ * @param aLo Start of the range in the original file
+ * @param aHi End of the range in the original file
+ * @param bLo Start of the range in the modified file
+ * @param bHi End of the range in the modified file
+ * @param removed Flags of removed lines in the original file
+ * @param inserted Flags of inserted lines in the modified file
+ */
+void DiffEngine::runEngine(const std::vector<std::uint32_t>& a,
+                           const std::vector<std::uint32_t>& b,
+                           int aLo, int aHi, int bLo, int bHi,
+                           std::vector<char>& removed,
+                           std::vector<char>& inserted) const
+{
+    // Number of steps after which the shortest edit script is no longer
+    // searched for. Only pathological inputs reach the limit
+    const int costLimit = getCostLimit((aHi - aLo) + (bHi - bLo));
+
+    if(options.getAlgorithm() == Algorithm::Patience)
+    {
+        PatienceDiff patience(a, b, idCount);
+        patience.setCostLimit(costLimit);
+        patience.calculate(aLo, aHi, bLo, bHi, removed, inserted);
+    }
+    else if(options.getAlgorithm() == Algorithm::Histogram)
+    {
+        HistogramDiff histogram(a, b, idCount);
+        histogram.setCostLimit(costLimit);
+        histogram.calculate(aLo, aHi, bLo, bHi, removed, inserted);
+    }
+    else if(BitParallelLcs::getTableSize(aHi - aLo, bHi - bLo) <=
+            options.getBitParallelBudget())
+    {
+        // Small and medium ranges are solved faster with
+        // bit-parallel operations, regardless of the number of changes
+        BitParallelLcs lcs(a, b, idCount);
+        lcs.calculate(aLo, aHi, bLo, bHi, removed, inserted);
+    }
+    else if(options.getThreadCount() > 1)
+    {
+        // Independent subproblems are solved on all threads
+        ThreadPool pool(options.getThreadCount());
+        MyersDiff myers(a, b, &pool);
+        myers.setCostLimit(costLimit);
+        myers.calculate(aLo, aHi, bLo, bHi, removed, inserted);
+    }
+    else
+    {
+        MyersDiff myers(a, b);
+        myers.setCostLimit(costLimit);
+        myers.calculate(aLo, aHi, bLo, bHi, removed, inserted);
+    }
+}
+
+/**
+ * @brief Remove lines that do not occur in the other file from the search.
+ * Such lines are marked as changed right away
+ *
+ * @param aLo Start of the range in the original file
+ * @param aHi End of the range in the original file
+ * @param bLo Start of the range in the modified file
+ * @param bHi End of the range in the modified file
+ * @param removed Flags of removed lines in the original file
+ * @param inserted Flags of inserted lines in the modified file
+ * @param oldLines IDs of remaining lines from the original file
+ * @param oldIndices Indices of remaining lines in the original file
+ * @param newLines IDs of remaining lines from the modified file
+ * @param newIndices Indices of remaining lines in the modified file
+ * @return true if any lines were removed from the search, false otherwise
+ */
+bool DiffEngine::discardUnmatchedLines(int aLo, int aHi, int bLo, int bHi,
+                                       std::vector<char>& removed,
+                                       std::vector<char>& inserted,
+                                       std::vector<std::uint32_t>& oldLines,
+                                       std::vector<int>& oldIndices,
+                                       std::vector<std::uint32_t>& newLines,
+                                       std::vector<int>& newIndices) const
+{
+    // Whether each ID occurs in the range of the original
+    // and the modified file
+    std::vector<char> inOld(idCount, 0);
+    std::vector<char> inNew(idCount, 0);
+    int discarded = 0;
+    int i;
+
+    for(i = aLo; i < aHi; i++) inOld[original[i]] = 1;
+    for(i = bLo; i < bHi; i++) inNew[modified[i]] = 1;
+
+    for(i = aLo; i < aHi; i++)
+    {
+        if(!inNew[original[i]]) discarded++;
+    }
+
+    for(i = bLo; i < bHi; i++)
+    {
+        if(!inOld[modified[i]]) discarded++;
+    }
+
+    if(discarded == 0) return false;
+
+    for(i = aLo; i < aHi; i++)
+    {
+        if(inNew[original[i]])
+        {
+            oldLines.push_back(original[i]);
+            oldIndices.push_back(i);
+        }
+        else
+        {
+            removed[i] = 1;
+        }
+    }
+
+    for(i = bLo; i < bHi; i++)
+    {
+        if(inOld[modified[i]])
+        {
+            newLines.push_back(modified[i]);
+            newIndices.push_back(i);
+        }
+        else
+        {
+            inserted[i] = 1;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Calculate the difference between ranges of both sequences.
+ * Flags of lines outside of the ranges are not changed
+ *
+ * @param aLo Start of the range in the original file
+ * @param aHi End of the range in the original file
+ * @param bLo Start of the range in the modified file
+ * @param bHi End of the range in the modified file
+ * @param removed Flags of removed lines in the original file
+ * @param inserted Flags of inserted lines in the modified file
+ */
+void DiffEngine::calculate(int aLo, int aHi, int bLo, int bHi,
+                           std::vector<char>& removed,
+                           std::vector<char>& inserted) const
+{
+    // Lines that occur in only one file are always changed,
+    // so the search runs only on lines that have a counterpart
+    std::vector<std::uint32_t> oldLines, newLines;
+    std::vector<int> oldIndices, newIndices;
+
+    if(discardUnmatchedLines(aLo, aHi, bLo, bHi, removed, inserted,
+                             oldLines, oldIndices, newLines, newIndices))
+    {
+        std::vector<char> oldRemoved(oldLines.size(), 0);
+        std::vector<char> newInserted(newLines.size(), 0);
+
+        runEngine(oldLines, newLines, 0, oldLines.size(), 0, newLines.size(),
+                  oldRemoved, newInserted);
+
+        // Map flags back to lines of both files
+        for(std::size_t i = 0; i < oldLines.size(); i++)
+            removed[oldIndices[i]] = oldRemoved[i];
+
+        for(std::size_t i = 0; i < newLines.size(); i++)
+            inserted[newIndices[i]] = newInserted[i];
+    }
+    else
+    {
+        runEngine(original, modified, aLo, aHi, bLo, bHi, removed, inserted);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef DIFF_ENGINE_H
+#define DIFF_ENGINE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "options.h"
+
+/**
+ * @brief Class that calculates the difference between ranges of two
+ * sequences of line IDs with the algorithm specified in options.
+ * Results are stored as flags of removed and inserted lines
+ *
+ */
+class DiffEngine
+{
+    private:
+        /**
+         * @brief IDs of lines from the original file
+         *
+         */
+        const std::vector<std::uint32_t>& original;
+        /**
+         * @brief IDs of lines from the modified file
+         *
+         */
+        const std::vector<std::uint32_t>& modified;
+        /**
+         * @brief Number of distinct IDs in both sequences
+         *
+         */
+        const std::uint32_t idCount;
+        /**
+         * @brief Program options
+         *
+         */
+        const Options& options;
+        /**
+         * @brief Get the number of steps of the middle snake search after
+         * which the search gives up on the shortest edit script. Like in GNU diff,
+         * the limit grows with the square root of the number of lines
+         *
+         * @param lines Number of lines in both ranges
+         * @return Maximum number of steps
+         */
+        int getCostLimit(int lines) const;
+        /**
+         * @brief Calculate the difference between ranges of two sequences
+         * of line IDs using the algorithm specified in options
+         *
+         * @param a IDs of lines from the original file
+         * @param b IDs of lines from the modified file
+         * @param aLo Start of the range in the original file
+         * @param aHi End of the range in the original file
+         * @param bLo Start of the range in the modified file
+         * @param bHi End of the range in the modified file
+         * @param removed Flags of removed lines in the original file
+         * @param inserted Flags of inserted lines in the modified file
+         */
+        void runEngine(const std::vector<std::uint32_t>& a,
+                       const std::vector<std::uint32_t>& b,
+                       int aLo, int aHi, int bLo, int bHi,
+                       std::vector<char>& removed,
+                       std::vector<char>& inserted) const;
+        /**
+         * @brief Remove lines that do not occur in the other file from the search.
+         * Such lines are marked as changed right away
+         *
+         * @param aLo Start of the range in the original file
+         * @param aHi End of the range in the original file
+         * @param bLo Start of the range in the modified file
+         * @param bHi End of the range in the modified file
+         * @param removed Flags of removed lines in the original file
+         * @param inserted Flags of inserted lines in the modified file
+         * @param oldLines IDs of remaining lines from the original file
+         * @param oldIndices Indices of remaining lines in the original file
+         * @param newLines IDs of remaining lines from the modified file
+         * @param newIndices Indices of remaining lines in the modified file
+         * @return true if any lines were removed from the search, false otherwise
+         */
+        bool discardUnmatchedLines(int aLo, int aHi, int bLo, int bHi,
+                                   std::vector<char>& removed,
+                                   std::vector<char>& inserted,
+                                   std::vector<std::uint32_t>& oldLines,
+                                   std::vector<int>& oldIndices,
+                                   std::vector<std::uint32_t>& newLines,
+                                   std::vector<int>& newIndices) const;
+
+    public:
+        /**
+         * @brief Initialize the engine
+         *
+         * @param original IDs of lines from the original file
+         * @param modified IDs of lines from the modified file
+         * @param idCount Number of distinct IDs in both sequences
+         * @param options Program options
+         */
+        DiffEngine(const std::vector<std::uint32_t>& original,
+                   const std::vector<std::uint32_t>& modified,
+                   std::uint32_t idCount,
+                   const Options& options);
+        /**
+         * @brief Calculate the difference between ranges of both sequences.
+         * Flags of lines outside of the ranges are not changed
+         *
+         * @param aLo Start of the range in the original file
+         * @param aHi End of the range in the original file
+         * @param bLo Start of the range in the modified file
+         * @param bHi End of the range in the modified file
+         * @param removed Flags of removed lines in the original file
+         * @param inserted Flags of inserted lines in the modified file
+         */
+        void calculate(int aLo, int aHi, int bLo, int bHi,
+                       std::vector<char>& removed,
+                       std::vector<char>& inserted) const;
+};
+
+#endif // DIFF_ENGINE_H
\ No newline at end of file
@@ -0,0 +1,405 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "diff_server.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "app_controller.h"
+
+#if !defined(_WIN32) // POSIX
+#include <csignal>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif // _WIN32
+
+#if !defined(_WIN32) // POSIX
+namespace
+{
+    /**
+     * @brief Read exactly the specified number of bytes
+     *
+     * @param fd File descriptor
+     * @param data Buffer for bytes
+     * @param size Number of bytes
+     * @return true if all bytes were read, false if the peer closed
+     * the connection before
+     */
+    bool readAll(int fd, char* data, std::size_t size)
+    {
+        ssize_t n;
+
+        while(size > 0)
+        {
+            n = read(fd, data, size);
+
+            if(n == 0) return false;
+
+            if(n < 0)
+            {
+                if(errno == EINTR) continue;
+                throw std::runtime_error(std::string("could not read the request: ") +
+                                         std::strerror(errno));
+            }
+
+            data += n;
+            size -= n;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Close file descriptors that were received
+     *
+     * @param descriptors File descriptors, -1 for missing ones
+     * @param count Number of file descriptors
+     */
+    void closeDescriptors(int* descriptors, std::size_t count)
+    {
+        for(std::size_t i = 0; i < count; i++)
+        {
+            if(descriptors[i] != -1) close(descriptors[i]);
+            descriptors[i] = -1;
+        }
+    }
+}
+#endif // _WIN32
+
+/**
+ * @brief Create the socket and start listening on it.
+ * A socket left by a server that is no longer running is replaced
+ *
+ * @param socketPath Path to the socket
+ * @param args List of valid command line arguments
+ */
+DiffServer::DiffServer(const std::string& socketPath, const std::vector<Argument>& args) :
+    socketPath(socketPath),     // Path to the socket
+    args(args),                 // List of valid command line arguments
+    cache(CACHE_CAPACITY),      // Cache is empty
+    listenFd(-1),               // Created below
+    homeFd(-1)                  // Opened below
+{
+#if defined(_WIN32) // Windows
+    throw std::runtime_error("server mode is not supported on Windows");
+#else // POSIX
+    struct sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if(socketPath.size() >= sizeof(address.sun_path))
+        throw std::invalid_argument("path to the socket is too long");
+
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+
+    homeFd = open(".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    if(homeFd == -1)
+        throw std::runtime_error("could not open the working directory");
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if(listenFd == -1)
+    {
+        close(homeFd);
+        throw std::runtime_error("could not create the socket");
+    }
+
+    struct stat attr;
+
+    // A socket nobody accepts connections on is left by a stopped server
+    if(lstat(socketPath.c_str(), &attr) == 0 && S_ISSOCK(attr.st_mode))
+    {
+        if(connect(listenFd, reinterpret_cast<struct sockaddr*>(&address),
+                   sizeof(address)) == 0)
+        {
+            close(listenFd);
+            close(homeFd);
+            throw std::runtime_error("another server is listening on " + socketPath);
+        }
+
+        unlink(socketPath.c_str());
+    }
+
+    // Only the owner may connect, clients read files and write
+    // to descriptors on behalf of the server
+    const mode_t mask = umask(077);
+    const int bound = bind(listenFd, reinterpret_cast<struct sockaddr*>(&address),
+                           sizeof(address));
+    umask(mask);
+
+    if(bound == -1 || listen(listenFd, SOMAXCONN) == -1)
+    {
+        close(listenFd);
+        close(homeFd);
+        throw std::runtime_error("could not listen on " + socketPath);
+    }
+#endif // _WIN32
+}
+
+/**
+ * @brief Close and remove the socket
+ *
+ */
+DiffServer::~DiffServer(void)
+{
+#if !defined(_WIN32) // POSIX
+    close(listenFd);
+    unlink(socketPath.c_str());
+    close(homeFd);
+#endif // _WIN32
+}
+
+/**
+ * @brief Receive the request, run it and send back the exit code
+ *
+ * @param connection Connected socket
+ */
+void DiffServer::handleRequest(int connection)
+{
+#if defined(_WIN32) // Windows
+    (void)connection;
+#else // POSIX
+    std::uint32_t length;
+    int descriptors[DESCRIPTOR_COUNT];
+    union
+    {
+        struct cmsghdr header;
+        char data[CMSG_SPACE(sizeof(descriptors))];
+    } control;
+    struct iovec part;
+    struct msghdr message;
+    ssize_t n;
+
+    part.iov_base = &length;
+    part.iov_len = sizeof(length);
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov = &part;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data;
+    message.msg_controllen = sizeof(control.data);
+
+    // Descriptors arrive together with the length of arguments
+    do
+    {
+        n = recvmsg(connection, &message, MSG_CMSG_CLOEXEC);
+    }
+    while(n == -1 && errno == EINTR);
+
+    if(n <= 0) return;
+
+    std::size_t count = 0;
+
+    for(struct cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr;
+        header = CMSG_NXTHDR(&message, header))
+    {
+        if(header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS)
+            continue;
+
+        const std::size_t received = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+
+        for(std::size_t i = 0; i < received; i++)
+        {
+            int fd;
+            std::memcpy(&fd, CMSG_DATA(header) + i * sizeof(int), sizeof(int));
+
+            if(count < DESCRIPTOR_COUNT) descriptors[count++] = fd;
+            else close(fd);
+        }
+    }
+
+    for(std::size_t i = count; i < DESCRIPTOR_COUNT; i++)
+        descriptors[i] = -1;
+
+    char status;
+
+    try
+    {
+        if(count != DESCRIPTOR_COUNT || (message.msg_flags & MSG_CTRUNC))
+            throw std::runtime_error("request without standard streams of the client");
+
+        if(!readAll(connection, reinterpret_cast<char*>(&length) + n, sizeof(length) - n))
+            throw std::runtime_error("request is incomplete");
+
+        if(length == 0 || length > MAX_REQUEST_SIZE)
+            throw std::runtime_error("request is too long");
+
+        std::string data(length, '\0');
+
+        if(!readAll(connection, &data[0], length))
+            throw std::runtime_error("request is incomplete");
+
+        // Arguments are terminated with null characters
+        std::vector<std::string> arguments;
+        std::size_t begin = 0, end;
+
+        while((end = data.find('\0', begin)) != std::string::npos)
+        {
+            arguments.push_back(data.substr(begin, end - begin));
+            begin = end + 1;
+        }
+
+        if(arguments.empty() || begin != data.size())
+            throw std::runtime_error("request is malformed");
+
+        status = static_cast<char>(runRequest(arguments, descriptors));
+    }
+    catch(...)
+    {
+        closeDescriptors(descriptors, DESCRIPTOR_COUNT);
+        throw;
+    }
+
+    closeDescriptors(descriptors, DESCRIPTOR_COUNT);
+
+    // The client may have gone away, nothing is left to do then
+    while(send(connection, &status, 1, MSG_NOSIGNAL) == -1 && errno == EINTR) { }
+#endif // _WIN32
+}
+
+/**
+ * @brief Run the request in the working directory
+ * and with standard streams of the client
+ *
+ * @param arguments Command line arguments of the client
+ * @param descriptors Working directory, standard input,
+ * output and error of the client
+ * @return Exit code
+ */
+int DiffServer::runRequest(std::vector<std::string>& arguments, const int* descriptors)
+{
+#if defined(_WIN32) // Windows
+    (void)arguments;
+    (void)descriptors;
+    return 1;
+#else // POSIX
+    int saved[DESCRIPTOR_COUNT - 1];
+    std::size_t i;
+
+    for(i = 0; i < DESCRIPTOR_COUNT - 1; i++)
+        saved[i] = dup(i);
+
+    if(saved[0] == -1 || saved[1] == -1 || saved[2] == -1)
+    {
+        closeDescriptors(saved, DESCRIPTOR_COUNT - 1);
+        throw std::runtime_error("could not save standard streams");
+    }
+
+    std::vector<char*> argv;
+
+    for(std::string& argument : arguments)
+        argv.push_back(&argument[0]);
+
+    argv.push_back(nullptr);
+
+    // Nothing of the server may be written to the client
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+
+    int status = 1;
+    const bool switched = fchdir(descriptors[0]) == 0 && dup2(descriptors[1], 0) != -1 &&
+                          dup2(descriptors[2], 1) != -1 && dup2(descriptors[3], 2) != -1;
+
+    if(switched)
+    {
+        try
+        {
+            AppController controller(static_cast<int>(arguments.size()), argv.data(), args);
+            controller.setFileCache(&cache);
+            status = controller.run();
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << "Error: " << e.what() << '\n';
+        }
+
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+    }
+
+    // Streams of the server are restored even if the request failed
+    for(i = 0; i < DESCRIPTOR_COUNT - 1; i++)
+        dup2(saved[i], i);
+
+    closeDescriptors(saved, DESCRIPTOR_COUNT - 1);
+
+    // The next request must not see the end of input of this one
+    std::clearerr(stdin);
+    std::cin.clear();
+
+    if(fchdir(homeFd) == -1)
+        throw std::runtime_error("could not restore the working directory");
+
+    if(!switched)
+        throw std::runtime_error("could not switch to the working directory "
+                                 "and standard streams of the client");
+
+    return status;
+#endif // _WIN32
+}
+
+/**
+ * @brief Serve clients until the process is stopped
+ *
+ */
+void DiffServer::run(void)
+{
+#if !defined(_WIN32) // POSIX
+    // Output of a client may be closed, e.g. a pipe to a pager.
+    // Writing to it must fail instead of stopping the server
+    std::signal(SIGPIPE, SIG_IGN);
+
+    int connection;
+
+    while(true)
+    {
+        connection = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+
+        if(connection == -1)
+        {
+            if(errno == EINTR || errno == ECONNABORTED) continue;
+            throw std::runtime_error("could not accept a connection");
+        }
+
+        try
+        {
+            handleRequest(connection);
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << "Error: " << e.what() << '\n';
+        }
+
+        close(connection);
+    }
+#endif // _WIN32
+}
\ No newline at end of file
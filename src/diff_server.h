@@ -0,0 +1,137 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef DIFF_SERVER_H
+#define DIFF_SERVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "argument.h"
+#include "file_cache.h"
+
+/**
+ * @brief Server that calculates the difference for clients connected to
+ * a Unix domain socket. A request contains command line arguments of the
+ * client, its working directory and its standard streams. The request is
+ * run the same way as the program itself, writing directly to streams
+ * of the client, and the exit code is sent back. Files read by requests
+ * are kept in the cache, so unchanged files are neither read nor split
+ * into lines again. Requests are run one at a time, because each request
+ * changes the working directory and standard streams of the process
+ *
+ */
+class DiffServer
+{
+    public:
+        /**
+         * @brief Number of file descriptors sent with the request:
+         * working directory, standard input, output and error
+         *
+         */
+        static const std::size_t DESCRIPTOR_COUNT = 4;
+        /**
+         * @brief Maximum size of arguments in the request in bytes
+         *
+         */
+        static const std::uint32_t MAX_REQUEST_SIZE = 1048576;
+
+    private:
+        /**
+         * @brief Maximum total size of cached files in bytes
+         *
+         */
+        static const std::size_t CACHE_CAPACITY = 268435456;
+        /**
+         * @brief Path to the socket
+         *
+         */
+        std::string socketPath;
+        /**
+         * @brief List of valid command line arguments
+         *
+         */
+        std::vector<Argument> args;
+        /**
+         * @brief Files read by requests
+         *
+         */
+        FileCache cache;
+        /**
+         * @brief Listening socket
+         *
+         */
+        int listenFd;
+        /**
+         * @brief Working directory of the server,
+         * restored after each request
+         *
+         */
+        int homeFd;
+        /**
+         * @brief Receive the request, run it and send back the exit code
+         *
+         * @param connection Connected socket
+         */
+        void handleRequest(int connection);
+        /**
+         * @brief Run the request in the working directory
+         * and with standard streams of the client
+         *
+         * @param arguments Command line arguments of the client
+         * @param descriptors Working directory, standard input,
+         * output and error of the client
+         * @return Exit code
+         */
+        int runRequest(std::vector<std::string>& arguments, const int* descriptors);
+
+    public:
+        /**
+         * @brief Create the socket and start listening on it.
+         * A socket left by a server that is no longer running is replaced
+         *
+         * @param socketPath Path to the socket
+         * @param args List of valid command line arguments
+         */
+        DiffServer(const std::string& socketPath, const std::vector<Argument>& args);
+        /**
+         * @brief Close and remove the socket
+         *
+         */
+        ~DiffServer(void);
+        /**
+         * @brief Socket is owned by a single object, so it cannot be copied
+         *
+         */
+        DiffServer(const DiffServer&) = delete;
+        DiffServer& operator=(const DiffServer&) = delete;
+        /**
+         * @brief Serve clients until the process is stopped
+         *
+         */
+        void run(void);
+};
+
+#endif // DIFF_SERVER_H
\ No newline at end of file
@@ -0,0 +1,279 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "diff_state.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "sha256.h"
+
+namespace
+{
+    /**
+     * @brief Bytes at the beginning of the state, including the version of the format
+     *
+     */
+    const std::string MAGIC = "CDIFFIN2";
+
+    /**
+     * @brief Append the number as 8 bytes in little-endian order
+     *
+     * @param out String that receives the number
+     * @param value Number
+     */
+    void putUint64(std::string& out, std::uint64_t value)
+    {
+        for(int i = 0; i < 8; i++)
+            out += static_cast<char>(value >> (8 * i));
+    }
+
+    /**
+     * @brief Read the number written by putUint64
+     *
+     * @param in String with the number, must have 8 bytes at the position
+     * @param pos Position of the number
+     * @return Number
+     */
+    std::uint64_t getUint64(const std::string& in, std::size_t pos)
+    {
+        std::uint64_t value = 0;
+
+        for(int i = 0; i < 8; i++)
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[pos + i])) << (8 * i);
+
+        return value;
+    }
+}
+
+/**
+ * @brief Initialize an empty state
+ *
+ * @param fname Path to the file with the state
+ */
+DiffState::DiffState(const std::string& fname) :
+    filename(fname),                // Path to the file with the state
+    modifiedHashes(),               // Read by load
+    modifiedChecks(),               // Read by load
+    modifiedEndingNewLine(true),    // Read by load
+    script() { }                    // Read by load
+
+/**
+ * @brief Get the digest of the original file and options
+ * that change the edit script
+ *
+ * @param originalFile Original file
+ * @param options Program options
+ * @return SHA-256 digest
+ */
+std::string DiffState::getKey(const MappedFile& originalFile, const Options& options)
+{
+    const std::string settings = MAGIC + ' ' + options.getScriptSignature() + '\n';
+    Sha256 sha;
+
+    sha.update(settings.data(), settings.size());
+    sha.update(originalFile.getData(), originalFile.getSize());
+
+    return sha.finish();
+}
+
+/**
+ * @brief Calculate the check value of the line. It is independent
+ * of the hash of the line, so both together collide far less often
+ *
+ * @param line Line
+ * @return Check value
+ */
+std::uint64_t DiffState::getCheck(const LineView& line)
+{
+    const std::uint64_t multiplier = 0xff51afd7ed558ccdULL;
+    const char* data = line.getData();
+    std::size_t len = line.getLength();
+    std::uint64_t h = 0x9e3779b97f4a7c15ULL * (len + 1);
+    std::uint64_t word;
+
+    // Mix 8 bytes at a time with other constants than LineTable::hash
+    while(len >= sizeof(word))
+    {
+        std::memcpy(&word, data, sizeof(word));
+        h = (h ^ word) * multiplier;
+        h = (h << 31) | (h >> 33);
+        data += sizeof(word);
+        len -= sizeof(word);
+    }
+
+    // Mix the remaining bytes
+    while(len > 0)
+    {
+        h = (h ^ static_cast<unsigned char>(*data)) * multiplier;
+        h = (h << 31) | (h >> 33);
+        data++;
+        len--;
+    }
+
+    // Final mix of MurmurHash3
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    return h ^ (h >> 33);
+}
+
+/**
+ * @brief Read the state of the previous run. States that are damaged
+ * or belong to another original file or options are ignored
+ *
+ * @param originalFile Original file
+ * @param options Program options
+ * @return true if the state can be used, false otherwise
+ */
+bool DiffState::load(const MappedFile& originalFile, const Options& options)
+{
+    std::ifstream file(filename, std::ios::binary);
+
+    // There is no previous run yet
+    if(!file.is_open()) return false;
+
+    const std::string data((std::istreambuf_iterator<char>(file)),
+                           std::istreambuf_iterator<char>());
+    const std::string key = getKey(originalFile, options);
+    std::size_t pos = MAGIC.size() + key.size() + 1 + 8;
+
+    if(file.bad() || data.size() < pos || data.compare(0, MAGIC.size(), MAGIC) != 0 ||
+       data.compare(MAGIC.size(), key.size(), key) != 0)
+        return false;
+
+    modifiedEndingNewLine = data[MAGIC.size() + key.size()] != 0;
+
+    const std::uint64_t count = getUint64(data, pos - 8);
+
+    if(count > (data.size() - pos) / 16) return false;
+
+    modifiedHashes.resize(count);
+    modifiedChecks.resize(count);
+
+    for(std::size_t i = 0; i < count; i++, pos += 8)
+        modifiedHashes[i] = getUint64(data, pos);
+
+    for(std::size_t i = 0; i < count; i++, pos += 8)
+        modifiedChecks[i] = getUint64(data, pos);
+
+    if(!script.decode(data, pos, originalFile.getLines().size(), count) ||
+       pos != data.size())
+    {
+        script.clear();
+        modifiedHashes.clear();
+        modifiedChecks.clear();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Write the state of this run for the next one
+ *
+ * @param originalFile Original file
+ * @param modifiedFile Modified file
+ * @param options Program options
+ * @param script Edit script of this run
+ */
+void DiffState::save(const MappedFile& originalFile, const MappedFile& modifiedFile,
+                     const Options& options, const EditScript& script) const
+{
+    const std::vector<std::uint64_t>& hashes = modifiedFile.getHashes();
+    std::string data = MAGIC + getKey(originalFile, options);
+
+    data += static_cast<char>(modifiedFile.hasEndingNewLine());
+    putUint64(data, hashes.size());
+
+    for(std::uint64_t hash : hashes)
+        putUint64(data, hash);
+
+    for(const LineView& line : modifiedFile.getLines())
+        putUint64(data, getCheck(line));
+
+    script.encode(originalFile.getLines().size(), hashes.size(), data);
+
+    // The previous state stays whole if writing fails
+    const std::string temp = filename + ".tmp";
+    std::ofstream file(temp, std::ios::binary);
+    file.write(data.data(), data.size());
+    file.close();
+
+#if defined(_WIN32) // Windows
+    // Files are not replaced by renaming on Windows
+    if(!file.fail()) std::remove(filename.c_str());
+#endif // _WIN32
+
+    if(file.fail() || std::rename(temp.c_str(), filename.c_str()) != 0)
+    {
+        std::remove(temp.c_str());
+        throw std::runtime_error("could not write " + filename);
+    }
+}
+
+/**
+ * @brief Get hashes of lines of the previous modified file
+ *
+ * @return Hash of each line
+ */
+const std::vector<std::uint64_t>& DiffState::getModifiedHashes(void) const
+{
+    return this->modifiedHashes;
+}
+
+/**
+ * @brief Check if the line of the previous modified file
+ * is the same as the given line, by its hash and check value
+ *
+ * @param index Index of the line in the previous modified file
+ * @param hash Hash of the given line
+ * @param line Given line
+ * @return true if lines are the same, false otherwise
+ */
+bool DiffState::isSameLine(std::size_t index, std::uint64_t hash, const LineView& line) const
+{
+    return modifiedHashes[index] == hash && modifiedChecks[index] == getCheck(line);
+}
+
+/**
+ * @brief Check if the previous modified file ends with a new line
+ *
+ * @return true if the file ends with a new line, false otherwise
+ */
+bool DiffState::getModifiedEndingNewLine(void) const
+{
+    return this->modifiedEndingNewLine;
+}
+
+/**
+ * @brief Get the edit script of the previous run
+ *
+ * @return Edit script
+ */
+const EditScript& DiffState::getScript(void) const
+{
+    return this->script;
+}
\ No newline at end of file
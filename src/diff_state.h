@@ -0,0 +1,150 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef DIFF_STATE_H
+#define DIFF_STATE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "edit_script.h"
+#include "line_view.h"
+#include "mapped_file.h"
+#include "options.h"
+
+/**
+ * @brief Edit script of the previous run saved to a file, together with
+ * hashes of lines of the modified file. When the modified file changes
+ * slightly between runs, only the changed part is compared again.
+ * The saved script is used only if the original file and options
+ * that change the edit script are the same. A line is taken as unchanged
+ * when two independent 64-bit hashes match, so an accidental collision
+ * is practically impossible, but lines made to collide on purpose are not
+ * detected
+ *
+ */
+class DiffState
+{
+    private:
+        /**
+         * @brief Path to the file with the state
+         *
+         */
+        std::string filename;
+        /**
+         * @brief Hashes of lines of the previous modified file
+         *
+         */
+        std::vector<std::uint64_t> modifiedHashes;
+        /**
+         * @brief Check values of lines of the previous modified file,
+         * independent of the hashes
+         *
+         */
+        std::vector<std::uint64_t> modifiedChecks;
+        /**
+         * @brief Whether the previous modified file ends with a new line
+         *
+         */
+        bool modifiedEndingNewLine;
+        /**
+         * @brief Edit script of the previous run
+         *
+         */
+        EditScript script;
+        /**
+         * @brief Get the digest of the original file and options
+         * that change the edit script
+         *
+         * @param originalFile Original file
+         * @param options Program options
+         * @return SHA-256 digest
+         */
+        static std::string getKey(const MappedFile& originalFile, const Options& options);
+        /**
+         * @brief Calculate the check value of the line. It is independent
+         * of the hash of the line, so both together collide far less often
+         *
+         * @param line Line
+         * @return Check value
+         */
+        static std::uint64_t getCheck(const LineView& line);
+
+    public:
+        /**
+         * @brief Initialize an empty state
+         *
+         * @param fname Path to the file with the state
+         */
+        explicit DiffState(const std::string& fname);
+        /**
+         * @brief Read the state of the previous run. States that are damaged
+         * or belong to another original file or options are ignored
+         *
+         * @param originalFile Original file
+         * @param options Program options
+         * @return true if the state can be used, false otherwise
+         */
+        bool load(const MappedFile& originalFile, const Options& options);
+        /**
+         * @brief Write the state of this run for the next one
+         *
+         * @param originalFile Original file
+         * @param modifiedFile Modified file
+         * @param options Program options
+         * @param script Edit script of this run
+         */
+        void save(const MappedFile& originalFile, const MappedFile& modifiedFile,
+                  const Options& options, const EditScript& script) const;
+        /**
+         * @brief Get hashes of lines of the previous modified file
+         *
+         * @return Hash of each line
+         */
+        const std::vector<std::uint64_t>& getModifiedHashes(void) const;
+        /**
+         * @brief Check if the line of the previous modified file
+         * is the same as the given line, by its hash and check value
+         *
+         * @param index Index of the line in the previous modified file
+         * @param hash Hash of the given line
+         * @param line Given line
+         * @return true if lines are the same, false otherwise
+         */
+        bool isSameLine(std::size_t index, std::uint64_t hash, const LineView& line) const;
+        /**
+         * @brief Check if the previous modified file ends with a new line
+         *
+         * @return true if the file ends with a new line, false otherwise
+         */
+        bool getModifiedEndingNewLine(void) const;
+        /**
+         * @brief Get the edit script of the previous run
+         *
+         * @return Edit script
+         */
+        const EditScript& getScript(void) const;
+};
+
+#endif // DIFF_STATE_H
\ No newline at end of file
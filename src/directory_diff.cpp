@@ -0,0 +1,148 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "directory_diff.h"
+
+#include <vector>
+
+#include "batch_diff.h"
+#include "file_helper.h"
+
+/**
+ * @brief Initialize parameters with specified values
+ *
+ * @param originalDir Path to the original directory
+ * @param modifiedDir Path to the modified directory
+ * @param options Program options
+ */
+DirectoryDiff::DirectoryDiff(const std::string& originalDir,
+                             const std::string& modifiedDir,
+                             Options& options) :
+    originalDir(originalDir),   // Path to the original directory
+    modifiedDir(modifiedDir),   // Path to the modified directory
+    options(options) { }        // Program options
+
+/**
+ * @brief Get the message about the file that exists only in one directory
+ *
+ * @param dir Directory the file exists in
+ * @param path Path of the file relative to the directory
+ * @return Message in the format of GNU diff
+ */
+std::string DirectoryDiff::getOnlyInMessage(const std::string& dir, const std::string& path)
+{
+    const std::size_t separator = path.rfind('/');
+
+    if(separator == std::string::npos)
+        return "Only in " + dir + ": " + path + '\n';
+
+    return "Only in " + dir + '/' + path.substr(0, separator) + ": " +
+           path.substr(separator + 1) + '\n';
+}
+
+/**
+ * @brief Get the top-most part of the path that does not exist
+ * in the other directory, so that a missing directory
+ * is reported once instead of every file in it
+ *
+ * @param otherDir Directory the file does not exist in
+ * @param path Path of the file relative to the directory
+ * @return Path of the top-most missing directory, or the path of the file
+ */
+std::string DirectoryDiff::getOneSidedPath(const std::string& otherDir, const std::string& path)
+{
+    std::size_t separator = path.find('/');
+
+    while(separator != std::string::npos)
+    {
+        if(!FileHelper::isDirectory(otherDir + '/' + path.substr(0, separator)))
+            return path.substr(0, separator);
+
+        separator = path.find('/', separator + 1);
+    }
+
+    return path;
+}
+
+/**
+ * @brief Skip files inside the directory that was reported as missing
+ *
+ * @param files Sorted relative paths of files
+ * @param index Index of the next file, moved past files inside the directory
+ * @param path Path of the reported file or directory
+ */
+void DirectoryDiff::skipInside(const std::vector<std::string>& files, std::size_t& index,
+                               const std::string& path)
+{
+    // Paths with the same prefix are next to each other in sorted order
+    while(index < files.size() && files[index].size() > path.size() &&
+          files[index].compare(0, path.size(), path) == 0 &&
+          files[index][path.size()] == '/')
+        index++;
+}
+
+/**
+ * @brief Compare both directories and print the difference
+ * to console or write it to file
+ *
+ * @return true if all files were compared, false otherwise
+ */
+bool DirectoryDiff::print(void)
+{
+    std::vector<std::string> originalFiles, modifiedFiles;
+
+    FileHelper::listFiles(originalDir, originalFiles);
+    FileHelper::listFiles(modifiedDir, modifiedFiles);
+
+    // Merge both sorted lists. Paths that exist in both trees are paired,
+    // paths that exist only in one tree are reported like GNU diff does,
+    // once for the top-most directory that is missing in the other tree
+    BatchDiff batch(options);
+    std::size_t i = 0, j = 0;
+    std::string path;
+
+    while(i < originalFiles.size() || j < modifiedFiles.size())
+    {
+        if(j == modifiedFiles.size() ||
+           (i < originalFiles.size() && originalFiles[i] < modifiedFiles[j]))
+        {
+            path = getOneSidedPath(modifiedDir, originalFiles[i++]);
+            batch.addMessage(getOnlyInMessage(originalDir, path));
+            skipInside(originalFiles, i, path);
+        }
+        else if(i == originalFiles.size() || modifiedFiles[j] < originalFiles[i])
+        {
+            path = getOneSidedPath(originalDir, modifiedFiles[j++]);
+            batch.addMessage(getOnlyInMessage(modifiedDir, path));
+            skipInside(modifiedFiles, j, path);
+        }
+        else
+        {
+            batch.addPair(originalDir + '/' + originalFiles[i], modifiedDir + '/' + modifiedFiles[j]);
+            i++;
+            j++;
+        }
+    }
+
+    return batch.print();
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef DIRECTORY_DIFF_H
+#define DIRECTORY_DIFF_H
+
+#include <string>
+#include <vector>
+
+#include "options.h"
+
+/**
+ * @brief Class for calculating the difference between two directory trees.
+ * Files with the same relative path are paired and compared as a batch,
+ * in the order of paths
+ *
+ */
+class DirectoryDiff
+{
+    private:
+        /**
+         * @brief Path to the original directory
+         *
+         */
+        std::string originalDir;
+        /**
+         * @brief Path to the modified directory
+         *
+         */
+        std::string modifiedDir;
+        /**
+         * @brief Program options
+         *
+         */
+        Options& options;
+        /**
+         * @brief Get the message about the file that exists only in one directory
+         *
+         * @param dir Directory the file exists in
+         * @param path Path of the file relative to the directory
+         * @return Message in the format of GNU diff
+         */
+        static std::string getOnlyInMessage(const std::string& dir, const std::string& path);
+        /**
+         * @brief Get the top-most part of the path that does not exist
+         * in the other directory, so that a missing directory
+         * is reported once instead of every file in it
+         *
+         * @param otherDir Directory the file does not exist in
+         * @param path Path of the file relative to the directory
+         * @return Path of the top-most missing directory, or the path of the file
+         */
+        static std::string getOneSidedPath(const std::string& otherDir, const std::string& path);
+        /**
+         * @brief Skip files inside the directory that was reported as missing
+         *
+         * @param files Sorted relative paths of files
+         * @param index Index of the next file, moved past files inside the directory
+         * @param path Path of the reported file or directory
+         */
+        static void skipInside(const std::vector<std::string>& files, std::size_t& index,
+                               const std::string& path);
+
+    public:
+        /**
+         * @brief Initialize parameters with specified values
+         *
+         * @param originalDir Path to the original directory
+         * @param modifiedDir Path to the modified directory
+         * @param options Program options
+         */
+        DirectoryDiff(const std::string& originalDir,
+                      const std::string& modifiedDir,
+                      Options& options);
+        /**
+         * @brief Compare both directories and print the difference
+         * to console or write it to file
+         *
+         * @return true if all files were compared, false otherwise
+         */
+        bool print(void);
+};
+
+#endif // DIRECTORY_DIFF_H
\ No newline at end of file
@@ -0,0 +1,110 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "edit_run.h"
+
+/**
+ * @brief Initialize parameters with specified values
+ *
+ * @param change Value that indicates how lines in the new file
+ * were changed compared to the original file
+ * @param lineOld Position in the original file where the run starts
+ * @param lineNew Position in the new file where the run starts
+ * @param length Number of lines in the run
+ */
+EditRun::EditRun(Change change, unsigned int lineOld, unsigned int lineNew,
+                 unsigned int length) :
+                 change(change), lineOld(lineOld),
+                 lineNew(lineNew), length(length) { }
+
+/**
+ * @brief Get the value that indicates how lines in the new file
+ * were changed compared to the original file
+ *
+ * @return Value that indicates how lines in the new file
+ * were changed compared to the original file
+ */
+Change EditRun::getChange(void) const
+{
+    return this->change;
+}
+
+/**
+ * @brief Get the position in the original file where the run starts
+ *
+ * @return Position in the original file where the run starts
+ */
+unsigned int EditRun::getLineOld(void) const
+{
+    return this->lineOld;
+}
+
+/**
+ * @brief Get the position in the new file where the run starts
+ *
+ * @return Position in the new file where the run starts
+ */
+unsigned int EditRun::getLineNew(void) const
+{
+    return this->lineNew;
+}
+
+/**
+ * @brief Get the number of lines in the run
+ *
+ * @return Number of lines in the run
+ */
+unsigned int EditRun::getLength(void) const
+{
+    return this->length;
+}
+
+/**
+ * @brief Set the number of lines in the run
+ *
+ * @param length Number of lines in the run
+ */
+void EditRun::setLength(unsigned int length)
+{
+    this->length = length;
+}
+
+/**
+ * @brief Get the number of lines the run takes in the original file
+ *
+ * @return Number of lines in the original file
+ */
+unsigned int EditRun::getLengthOld(void) const
+{
+    return (change == Change::Insert) ? 0 : length;
+}
+
+/**
+ * @brief Get the number of lines the run takes in the new file
+ *
+ * @return Number of lines in the new file
+ */
+unsigned int EditRun::getLengthNew(void) const
+{
+    return (change == Change::Remove) ? 0 : length;
+}
\ No newline at end of file
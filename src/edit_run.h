@@ -0,0 +1,116 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EDIT_RUN_H
+#define EDIT_RUN_H
+
+#include "diff_item.h"
+
+/**
+ * @brief Class that represents consecutive lines with the same change
+ *
+ */
+class EditRun
+{
+    private:
+        /**
+         * @brief Value that indicates how lines in the new file
+         * were changed compared to the original file
+         *
+         */
+        Change change;
+        /**
+         * @brief Position in the original file where the run starts
+         *
+         */
+        unsigned int lineOld;
+        /**
+         * @brief Position in the new file where the run starts
+         *
+         */
+        unsigned int lineNew;
+        /**
+         * @brief Number of lines in the run
+         *
+         */
+        unsigned int length;
+
+    public:
+        /**
+         * @brief Initialize parameters with specified values
+         *
+         * @param change Value that indicates how lines in the new file
+         * were changed compared to the original file
+         * @param lineOld Position in the original file where the run starts
+         * @param lineNew Position in the new file where the run starts
+         * @param length Number of lines in the run
+         */
+        EditRun(Change change, unsigned int lineOld, unsigned int lineNew,
+                unsigned int length);
+        /**
+         * @brief Get the value that indicates how lines in the new file
+         * were changed compared to the original file
+         *
+         * @return Value that indicates how lines in the new file
+         * were changed compared to the original file
+         */
+        Change getChange(void) const;
+        /**
+         * @brief Get the position in the original file where the run starts
+         *
+         * @return Position in the original file where the run starts
+         */
+        unsigned int getLineOld(void) const;
+        /**
+         * @brief Get the position in the new file where the run starts
+         *
+         * @return Position in the new file where the run starts
+         */
+        unsigned int getLineNew(void) const;
+        /**
+         * @brief Get the number of lines in the run
+         *
+         * @return Number of lines in the run
+         */
+        unsigned int getLength(void) const;
+        /**
+         * @brief Set the number of lines in the run
+         *
+         * @param length Number of lines in the run
+         */
+        void setLength(unsigned int length);
+        /**
+         * @brief Get the number of lines the run takes in the original file
+         *
+         * @return Number of lines in the original file
+         */
+        unsigned int getLengthOld(void) const;
+        /**
+         * @brief Get the number of lines the run takes in the new file
+         *
+         * @return Number of lines in the new file
+         */
+        unsigned int getLengthNew(void) const;
+};
+
+#endif // EDIT_RUN_H
\ No newline at end of file
@@ -0,0 +1,318 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "edit_script.h"
+
+#include <cstdint>
+
+namespace
+{
+    /**
+     * @brief Append the number using 7 bits per byte
+     *
+     * @param out String that receives the number
+     * @param value Number
+     */
+    void putVarint(std::string& out, std::uint64_t value)
+    {
+        while(value >= 0x80)
+        {
+            out += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+
+        out += static_cast<char>(value);
+    }
+
+    /**
+     * @brief Read the number written by putVarint
+     *
+     * @param in String with the number
+     * @param pos Position of the number, moved past it
+     * @param value Number
+     * @return true if the number was read, false if the string ends before
+     */
+    bool getVarint(const std::string& in, std::size_t& pos, std::uint64_t& value)
+    {
+        unsigned int shift = 0;
+        unsigned char byte;
+
+        value = 0;
+
+        do
+        {
+            if(pos == in.size() || shift > 63) return false;
+
+            byte = static_cast<unsigned char>(in[pos++]);
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            shift += 7;
+        }
+        while(byte & 0x80);
+
+        return true;
+    }
+}
+
+/**
+ * @brief Initialize iterator at the specified line
+ *
+ * @param runs Runs of the script
+ * @param run Index of the run
+ * @param offset Index of the line within the run
+ */
+EditScript::const_iterator::const_iterator(const std::vector<EditRun>* runs,
+                                           std::size_t run,
+                                           unsigned int offset) :
+                                           runs(runs), run(run),
+                                           offset(offset)
+{
+    // Iterator past the last line of the run points
+    // to the first line of the next run
+    if(run < runs->size() && offset == (*runs)[run].getLength())
+    {
+        this->run++;
+        this->offset = 0;
+    }
+}
+
+/**
+ * @brief Get the change of the current line. A removed line
+ * refers to the position in the new file where it was
+ * removed, and an inserted line refers to the position
+ * in the original file where it was inserted
+ *
+ * @return Change of the current line
+ */
+DiffItem EditScript::const_iterator::operator*(void) const
+{
+    const EditRun& r = (*runs)[run];
+
+    return DiffItem(r.getChange(),
+        r.getLineOld() + ((r.getChange() == Change::Insert) ? 0 : offset),
+        r.getLineNew() + ((r.getChange() == Change::Remove) ? 0 : offset));
+}
+
+/**
+ * @brief Move to the next line
+ *
+ * @return Reference to the iterator
+ */
+EditScript::const_iterator& EditScript::const_iterator::operator++(void)
+{
+    if(++offset == (*runs)[run].getLength())
+    {
+        run++;
+        offset = 0;
+    }
+
+    return *this;
+}
+
+/**
+ * @brief Move to the next line
+ *
+ * @return Iterator before moving
+ */
+EditScript::const_iterator EditScript::const_iterator::operator++(int)
+{
+    const_iterator it = *this;
+    ++(*this);
+    return it;
+}
+
+/**
+ * @brief Check if iterators point to the same line
+ *
+ * @param other Other iterator
+ * @return true if iterators point to the same line, false otherwise
+ */
+bool EditScript::const_iterator::operator==(const const_iterator& other) const
+{
+    return run == other.run && offset == other.offset;
+}
+
+/**
+ * @brief Check if iterators point to different lines
+ *
+ * @param other Other iterator
+ * @return true if iterators point to different lines, false otherwise
+ */
+bool EditScript::const_iterator::operator!=(const const_iterator& other) const
+{
+    return !(*this == other);
+}
+
+/**
+ * @brief Initialize an empty script
+ *
+ */
+EditScript::EditScript(void) : runs() { }
+
+/**
+ * @brief Add lines to the end of the script. Lines are merged
+ * into the last run if they continue it
+ *
+ * @param change Value that indicates how lines in the new file
+ * were changed compared to the original file
+ * @param lineOld Position in the original file
+ * @param lineNew Position in the new file
+ * @param length Number of lines
+ */
+void EditScript::append(Change change, unsigned int lineOld,
+                        unsigned int lineNew, unsigned int length)
+{
+    if(length == 0) return;
+
+    if(!runs.empty())
+    {
+        EditRun& last = runs.back();
+
+        if(last.getChange() == change &&
+           last.getLineOld() + last.getLengthOld() == lineOld &&
+           last.getLineNew() + last.getLengthNew() == lineNew)
+        {
+            last.setLength(last.getLength() + length);
+            return;
+        }
+    }
+
+    runs.push_back(EditRun(change, lineOld, lineNew, length));
+}
+
+/**
+ * @brief Remove all runs
+ *
+ */
+void EditScript::clear(void)
+{
+    runs.clear();
+}
+
+/**
+ * @brief Get runs of the script
+ *
+ * @return Runs of consecutive lines with the same change
+ */
+const std::vector<EditRun>& EditScript::getRuns(void) const
+{
+    return this->runs;
+}
+
+/**
+ * @brief Get the iterator at the first line of the script
+ *
+ * @return Iterator at the first line
+ */
+EditScript::const_iterator EditScript::begin(void) const
+{
+    return const_iterator(&runs, 0, 0);
+}
+
+/**
+ * @brief Get the iterator past the last line of the script
+ *
+ * @return Iterator past the last line
+ */
+EditScript::const_iterator EditScript::end(void) const
+{
+    return const_iterator(&runs, runs.size(), 0);
+}
+
+/**
+ * @brief Get the iterator at the specified line of the run
+ *
+ * @param run Index of the run
+ * @param offset Index of the line within the run
+ * @return Iterator at the specified line
+ */
+EditScript::const_iterator EditScript::iteratorAt(std::size_t run,
+                                                  unsigned int offset) const
+{
+    return const_iterator(&runs, run, offset);
+}
+
+/**
+ * @brief Append the compact form of the script to the string. Runs are
+ * stored as their lengths and changes, positions follow from previous runs
+ *
+ * @param originalCount Number of lines in the original file
+ * @param modifiedCount Number of lines in the modified file
+ * @param out String that receives the script
+ */
+void EditScript::encode(std::size_t originalCount, std::size_t modifiedCount,
+                        std::string& out) const
+{
+    putVarint(out, originalCount);
+    putVarint(out, modifiedCount);
+    putVarint(out, runs.size());
+
+    for(const EditRun& run : runs)
+        putVarint(out, (static_cast<std::uint64_t>(run.getLength()) << 2) |
+                       static_cast<std::uint64_t>(run.getChange()));
+}
+
+/**
+ * @brief Replace the script with the one written by encode. The script must
+ * cover exactly the specified number of lines in both files
+ *
+ * @param in String with the script
+ * @param pos Position of the script, moved past it
+ * @param originalCount Number of lines in the original file
+ * @param modifiedCount Number of lines in the modified file
+ * @return true if the script was read, false if it is damaged
+ * or does not match the number of lines
+ */
+bool EditScript::decode(const std::string& in, std::size_t& pos,
+                        std::size_t originalCount, std::size_t modifiedCount)
+{
+    std::uint64_t n, m, count, value, length;
+    std::uint64_t lineOld = 0, lineNew = 0;
+    Change change;
+
+    runs.clear();
+
+    if(!getVarint(in, pos, n) || !getVarint(in, pos, m) ||
+       !getVarint(in, pos, count) || n != originalCount || m != modifiedCount)
+        return false;
+
+    for(; count > 0; count--)
+    {
+        if(!getVarint(in, pos, value) || (value & 3) > 2) return false;
+
+        change = static_cast<Change>(value & 3);
+        length = value >> 2;
+
+        if(length == 0 ||
+           (change != Change::Insert && length > n - lineOld) ||
+           (change != Change::Remove && length > m - lineNew))
+            return false;
+
+        append(change, static_cast<unsigned int>(lineOld),
+               static_cast<unsigned int>(lineNew), static_cast<unsigned int>(length));
+
+        if(change != Change::Insert) lineOld += length;
+        if(change != Change::Remove) lineNew += length;
+    }
+
+    return lineOld == n && lineNew == m;
+}
\ No newline at end of file
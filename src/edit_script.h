@@ -0,0 +1,201 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EDIT_SCRIPT_H
+#define EDIT_SCRIPT_H
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "diff_item.h"
+#include "edit_run.h"
+
+/**
+ * @brief Sequence of changes stored as runs of consecutive lines
+ * with the same change. Memory depends on the number of changes
+ * rather than on the number of lines
+ *
+ */
+class EditScript
+{
+    private:
+        /**
+         * @brief Runs of consecutive lines with the same change
+         *
+         */
+        std::vector<EditRun> runs;
+
+    public:
+        /**
+         * @brief Iterator that walks the script line by line
+         * and yields a DiffItem for each line
+         *
+         */
+        class const_iterator
+        {
+            private:
+                /**
+                 * @brief Runs of the script
+                 *
+                 */
+                const std::vector<EditRun>* runs;
+                /**
+                 * @brief Index of the current run
+                 *
+                 */
+                std::size_t run;
+                /**
+                 * @brief Index of the line within the current run
+                 *
+                 */
+                unsigned int offset;
+
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef DiffItem value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef const DiffItem* pointer;
+                typedef DiffItem reference;
+
+                /**
+                 * @brief Initialize iterator at the specified line
+                 *
+                 * @param runs Runs of the script
+                 * @param run Index of the run
+                 * @param offset Index of the line within the run
+                 */
+                const_iterator(const std::vector<EditRun>* runs,
+                               std::size_t run, unsigned int offset);
+                /**
+                 * @brief Get the change of the current line. A removed line
+                 * refers to the position in the new file where it was
+                 * removed, and an inserted line refers to the position
+                 * in the original file where it was inserted
+                 *
+                 * @return Change of the current line
+                 */
+                DiffItem operator*(void) const;
+                /**
+                 * @brief Move to the next line
+                 *
+                 * @return Reference to the iterator
+                 */
+                const_iterator& operator++(void);
+                /**
+                 * @brief Move to the next line
+                 *
+                 * @return Iterator before moving
+                 */
+                const_iterator operator++(int);
+                /**
+                 * @brief Check if iterators point to the same line
+                 *
+                 * @param other Other iterator
+                 * @return true if iterators point to the same line, false otherwise
+                 */
+                bool operator==(const const_iterator& other) const;
+                /**
+                 * @brief Check if iterators point to different lines
+                 *
+                 * @param other Other iterator
+                 * @return true if iterators point to different lines, false otherwise
+                 */
+                bool operator!=(const const_iterator& other) const;
+        };
+
+        /**
+         * @brief Initialize an empty script
+         *
+         */
+        EditScript(void);
+        /**
+         * @brief Add lines to the end of the script. Lines are merged
+         * into the last run if they continue it
+         *
+         * @param change Value that indicates how lines in the new file
+         * were changed compared to the original file
+         * @param lineOld Position in the original file
+         * @param lineNew Position in the new file
+         * @param length Number of lines
+         */
+        void append(Change change, unsigned int lineOld, unsigned int lineNew,
+                    unsigned int length);
+        /**
+         * @brief Remove all runs
+         *
+         */
+        void clear(void);
+        /**
+         * @brief Get runs of the script
+         *
+         * @return Runs of consecutive lines with the same change
+         */
+        const std::vector<EditRun>& getRuns(void) const;
+        /**
+         * @brief Get the iterator at the first line of the script
+         *
+         * @return Iterator at the first line
+         */
+        const_iterator begin(void) const;
+        /**
+         * @brief Get the iterator past the last line of the script
+         *
+         * @return Iterator past the last line
+         */
+        const_iterator end(void) const;
+        /**
+         * @brief Get the iterator at the specified line of the run
+         *
+         * @param run Index of the run
+         * @param offset Index of the line within the run
+         * @return Iterator at the specified line
+         */
+        const_iterator iteratorAt(std::size_t run, unsigned int offset) const;
+        /**
+         * @brief Append the compact form of the script to the string. Runs are
+         * stored as their lengths and changes, positions follow from previous runs
+         *
+         * @param originalCount Number of lines in the original file
+         * @param modifiedCount Number of lines in the modified file
+         * @param out String that receives the script
+         */
+        void encode(std::size_t originalCount, std::size_t modifiedCount,
+                    std::string& out) const;
+        /**
+         * @brief Replace the script with the one written by encode. The script must
+         * cover exactly the specified number of lines in both files
+         *
+         * @param in String with the script
+         * @param pos Position of the script, moved past it
+         * @param originalCount Number of lines in the original file
+         * @param modifiedCount Number of lines in the modified file
+         * @return true if the script was read, false if it is damaged
+         * or does not match the number of lines
+         */
+        bool decode(const std::string& in, std::size_t& pos,
+                    std::size_t originalCount, std::size_t modifiedCount);
+};
+
+#endif // EDIT_SCRIPT_H
\ No newline at end of file
@@ -0,0 +1,161 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "file_cache.h"
+
+#if !defined(_WIN32) // POSIX
+#include <sys/stat.h>
+#endif // _WIN32
+
+/**
+ * @brief Compare identities of files
+ *
+ * @param other Other identity
+ * @return true if this identity goes first, false otherwise
+ */
+bool FileCache::Key::operator<(const Key& other) const
+{
+    if(path != other.path) return path < other.path;
+    if(device != other.device) return device < other.device;
+    if(inode != other.inode) return inode < other.inode;
+    if(seconds != other.seconds) return seconds < other.seconds;
+    if(nanoseconds != other.nanoseconds) return nanoseconds < other.nanoseconds;
+    return size < other.size;
+}
+
+/**
+ * @brief Check if identities of files are the same
+ *
+ * @param other Other identity
+ * @return true if identities are the same, false otherwise
+ */
+bool FileCache::Key::operator==(const Key& other) const
+{
+    return path == other.path && device == other.device && inode == other.inode &&
+           seconds == other.seconds && nanoseconds == other.nanoseconds &&
+           size == other.size;
+}
+
+/**
+ * @brief Initialize an empty cache
+ *
+ * @param capacity Maximum total size of cached files in bytes
+ */
+FileCache::FileCache(std::size_t capacity) :
+    capacity(capacity), // Maximum total size of cached files
+    totalSize(0),       // Cache is empty
+    entries(),          // No files yet
+    index(),            // No files yet
+    lock() { }          // Lock for the cache
+
+/**
+ * @brief Get the identity of the file
+ *
+ * @param fname Path to the file
+ * @param key Identity of the file
+ * @return true if the file is a regular file that can be cached,
+ * false otherwise
+ */
+bool FileCache::getKey(const std::string& fname, Key& key)
+{
+#if defined(_WIN32) // Windows
+    // Files are cached only by the server, which is not available on Windows
+    (void)fname;
+    (void)key;
+    return false;
+#else // POSIX
+    struct stat attr;
+
+    // Pipes and devices may return different contents each time
+    if(stat(fname.c_str(), &attr) != 0 || !S_ISREG(attr.st_mode))
+        return false;
+
+    key.path = fname;
+    key.device = attr.st_dev;
+    key.inode = attr.st_ino;
+    key.seconds = attr.st_mtim.tv_sec;
+    key.nanoseconds = attr.st_mtim.tv_nsec;
+    key.size = attr.st_size;
+
+    return true;
+#endif // _WIN32
+}
+
+/**
+ * @brief Get the file from the cache or read it. Lines split by
+ * the caller are kept with the file for later requests
+ *
+ * @param fname Path to the file
+ * @return File
+ */
+std::shared_ptr<MappedFile> FileCache::get(const std::string& fname)
+{
+    Key key, keyAfter;
+
+    if(!getKey(fname, key))
+        return std::make_shared<MappedFile>(fname);
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = index.find(key);
+
+        if(it != index.end())
+        {
+            // Move the file to the front of the list
+            entries.splice(entries.begin(), entries, it->second);
+            return it->second->file;
+        }
+    }
+
+    // The file is read without holding the lock,
+    // so other files are loaded at the same time
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(fname);
+
+    // The file was changed while it was read, its contents
+    // may belong to neither version, so it is not cached
+    if(!getKey(fname, keyAfter) || !(keyAfter == key))
+        return file;
+
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = index.find(key);
+
+    // Another thread has read the same file
+    if(it != index.end())
+        return it->second->file;
+
+    entries.push_front(Entry{key, file});
+    index[key] = entries.begin();
+    totalSize += file->getSize();
+
+    // Drop the least recently used files, but keep the new one
+    // even if it does not fit. Files that are still in use stay
+    // alive until they are released
+    while(totalSize > capacity && entries.size() > 1)
+    {
+        totalSize -= entries.back().file->getSize();
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+
+    return file;
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FILE_CACHE_H
+#define FILE_CACHE_H
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "mapped_file.h"
+
+/**
+ * @brief Cache of files that were read recently, together with their
+ * lines and hashes of lines. A file is identified by its path, device,
+ * inode, last modification time and size, so a file that was changed
+ * is read again. The least recently used files are dropped when the
+ * total size of files exceeds the capacity
+ *
+ */
+class FileCache
+{
+    private:
+        /**
+         * @brief Identity of the file
+         *
+         */
+        struct Key
+        {
+            std::string path;
+            unsigned long long device;
+            unsigned long long inode;
+            long long seconds;
+            long long nanoseconds;
+            unsigned long long size;
+
+            bool operator<(const Key& other) const;
+            bool operator==(const Key& other) const;
+        };
+        /**
+         * @brief Cached file
+         *
+         */
+        struct Entry
+        {
+            Key key;
+            std::shared_ptr<MappedFile> file;
+        };
+        /**
+         * @brief Maximum total size of cached files in bytes
+         *
+         */
+        const std::size_t capacity;
+        /**
+         * @brief Total size of cached files in bytes
+         *
+         */
+        std::size_t totalSize;
+        /**
+         * @brief Cached files, the most recently used first
+         *
+         */
+        std::list<Entry> entries;
+        /**
+         * @brief Position of each file in the list
+         *
+         */
+        std::map<Key, std::list<Entry>::iterator> index;
+        /**
+         * @brief Lock for the cache, files may be loaded on several threads
+         *
+         */
+        std::mutex lock;
+        /**
+         * @brief Get the identity of the file
+         *
+         * @param fname Path to the file
+         * @param key Identity of the file
+         * @return true if the file is a regular file that can be cached,
+         * false otherwise
+         */
+        static bool getKey(const std::string& fname, Key& key);
+
+    public:
+        /**
+         * @brief Initialize an empty cache
+         *
+         * @param capacity Maximum total size of cached files in bytes
+         */
+        explicit FileCache(std::size_t capacity);
+        /**
+         * @brief Get the file from the cache or read it. Lines split by
+         * the caller are kept with the file for later requests
+         *
+         * @param fname Path to the file
+         * @return File
+         */
+        std::shared_ptr<MappedFile> get(const std::string& fname);
+};
+
+#endif // FILE_CACHE_H
\ No newline at end of file
@@ -23,13 +23,98 @@
 
 #include "file_helper.h"
 
-#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+#if !defined(_WIN32) // POSIX
+#include <dirent.h>
+#endif // _WIN32
+
+namespace
+{
+    /**
+     * @brief Add files of the directory and its subdirectories to the vector
+     *
+     * @param root Path to the top directory
+     * @param prefix Path of the current directory relative to the top one,
+     * empty or ending with '/'
+     * @param files Vector that receives paths of files
+     */
+    void listFilesIn(const std::string& root, const std::string& prefix,
+                     std::vector<std::string>& files)
+    {
+        const std::string dir = root + '/' + prefix;
 
 #if defined(_WIN32) // Windows
-#include <windows.h>
+        WIN32_FIND_DATAA data;
+        HANDLE hFind = FindFirstFileA((dir + '*').c_str(), &data);
+
+        if(hFind == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("could not read directory " + dir);
+
+        do
+        {
+            const std::string name = data.cFileName;
+
+            if(name == "." || name == "..") continue;
+
+            // Junctions and symbolic links to directories are not followed
+            if(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+            {
+                if(!(data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT))
+                    listFilesIn(root, prefix + name + '/', files);
+            }
+            else
+            {
+                files.push_back(prefix + name);
+            }
+        } while(FindNextFileA(hFind, &data));
+
+        FindClose(hFind);
 #else // POSIX
-#include <sys/stat.h>
+        DIR* handle = opendir(dir.c_str());
+
+        if(handle == nullptr)
+            throw std::runtime_error("could not read directory " + dir);
+
+        std::vector<std::string> names;
+        struct dirent* entry;
+
+        while((entry = readdir(handle)) != nullptr)
+        {
+            const std::string name = entry->d_name;
+
+            if(name != "." && name != "..") names.push_back(name);
+        }
+
+        closedir(handle);
+
+        for(const std::string& name : names)
+        {
+            struct stat attr;
+
+            if(lstat((dir + name).c_str(), &attr) != 0)
+                throw std::runtime_error("could not get attributes of " + dir + name);
+
+            // Links to files are compared as files, links to directories are skipped
+            if(S_ISLNK(attr.st_mode) && stat((dir + name).c_str(), &attr) != 0)
+                continue;
+
+            if(S_ISDIR(attr.st_mode))
+            {
+                struct stat link;
+
+                if(lstat((dir + name).c_str(), &link) == 0 && !S_ISLNK(link.st_mode))
+                    listFilesIn(root, prefix + name + '/', files);
+            }
+            else if(S_ISREG(attr.st_mode))
+            {
+                files.push_back(prefix + name);
+            }
+        }
 #endif // _WIN32
+    }
+}
 
 /**
  * @brief Get the last modification date of the specified file.
@@ -48,6 +133,38 @@ void FileHelper::getLastModifiedDate(const std::string& fname, DateTime& dt)
     if(hFile == INVALID_HANDLE_VALUE)
         throw std::runtime_error("could not get a handle for the file");
 
+    try
+    {
+        getLastModifiedDate(hFile, dt);
+    }
+    catch(...)
+    {
+        CloseHandle(hFile);
+        throw;
+    }
+
+    CloseHandle(hFile);
+#else // POSIX
+    struct stat attr;
+
+    // Get file attributes
+    if(stat(fname.c_str(), &attr))
+        throw std::runtime_error("could not get last modification date of the file");
+
+    getLastModifiedDate(attr, dt);
+#endif // _WIN32
+}
+
+#if defined(_WIN32) // Windows
+/**
+ * @brief Get the last modification date of the opened file.
+ * A date and time returned by the function is a local time
+ *
+ * @param hFile Handle to the file
+ * @param dt Object of the class that will hold the date and time
+ */
+void FileHelper::getLastModifiedDate(HANDLE hFile, DateTime& dt)
+{
     FILETIME ft;
     SYSTEMTIME stUTC, stLocal;
 
@@ -55,8 +172,6 @@ void FileHelper::getLastModifiedDate(const std::string& fname, DateTime& dt)
     if(!GetFileTime(hFile, NULL, NULL, &ft))
         throw std::runtime_error("could not get last modification date of the file");
 
-    CloseHandle(hFile);
-
     // Convert FILETIME to SYSTEMTIME
     if(!FileTimeToSystemTime(&ft, &stUTC))
         throw std::runtime_error("could not convert time to appropriate format");
@@ -75,15 +190,22 @@ void FileHelper::getLastModifiedDate(const std::string& fname, DateTime& dt)
     dt.setNanoseconds(stLocal.wMilliseconds); // Program will store
                                               // milliseconds instead of
                                               // nanoseconds for Windows
+}
 #else // POSIX
-    struct stat attr;
-
-    // Get file attributes
-    if(stat(fname.c_str(), &attr))
-        throw std::runtime_error("could not get last modification date of the file");
+/**
+ * @brief Get the last modification date from attributes of the file.
+ * A date and time returned by the function is a local time
+ *
+ * @param attr Attributes of the file
+ * @param dt Object of the class that will hold the date and time
+ */
+void FileHelper::getLastModifiedDate(const struct stat& attr, DateTime& dt)
+{
+    std::tm local;
 
-    // Convert to local time
-    std::tm* t = std::localtime(&attr.st_mtim.tv_sec);
+    // Convert to local time. Files may be opened on several threads,
+    // so the reentrant version is used
+    std::tm* t = localtime_r(&attr.st_mtim.tv_sec, &local);
 
     if(t == nullptr)
         throw std::runtime_error("could not convert time to appropriate format");
@@ -96,32 +218,43 @@ void FileHelper::getLastModifiedDate(const std::string& fname, DateTime& dt)
     dt.setMinute(t->tm_min);
     dt.setSecond(t->tm_sec);
     dt.setNanoseconds(attr.st_mtim.tv_nsec);
-#endif // _WIN32
 }
+#endif // _WIN32
 
 /**
- * @brief Check if a file has empty line at the end (ends with '\n')
+ * @brief Check if the path refers to a directory
  *
- * @param fname Path to the file
- * @return true if a file has empty line at the end, false otherwise
+ * @param path Path
+ * @return true if the path is a directory, false otherwise
  */
-bool FileHelper::hasEndingNewLine(const std::string &fname)
+bool FileHelper::isDirectory(const std::string& path)
 {
-    char c;
-
-    // Open the file
-    std::ifstream file(fname);
+#if defined(_WIN32) // Windows
+    const DWORD attributes = GetFileAttributesA(path.c_str());
 
-    // Check if file is open
-    if(!file.is_open())
-        throw std::ios_base::failure("failed to open a file");
+    return attributes != INVALID_FILE_ATTRIBUTES &&
+           (attributes & FILE_ATTRIBUTE_DIRECTORY);
+#else // POSIX
+    struct stat attr;
 
-    // Jump to the one position before EOF
-    file.seekg(-1, std::ios_base::end);
+    return stat(path.c_str(), &attr) == 0 && S_ISDIR(attr.st_mode);
+#endif // _WIN32
+}
 
-    // Get last character
-    file.get(c);
+/**
+ * @brief List files in the directory and all its subdirectories.
+ * Paths are relative to the directory, use '/' as a separator
+ * and are sorted. Links to directories are not followed,
+ * so that cycles are not possible
+ *
+ * @param dir Path to the directory
+ * @param files Vector that receives paths of files
+ */
+void FileHelper::listFiles(const std::string& dir, std::vector<std::string>& files)
+{
+    files.clear();
+    listFilesIn(dir, "", files);
 
-    // Check for new line
-    return c == '\n';
+    // Order of entries in a directory depends on the file system
+    std::sort(files.begin(), files.end());
 }
\ No newline at end of file
@@ -26,9 +26,16 @@
 
 #include <ctime>
 #include <string>
+#include <vector>
 
 #include "date_time.h"
 
+#if defined(_WIN32) // Windows
+#include <windows.h>
+#else // POSIX
+#include <sys/stat.h>
+#endif // _WIN32
+
 /**
  * @brief Namespace containing helper functions to work with files
  *
@@ -43,13 +50,42 @@ namespace FileHelper
      * @param dt Object of the class that will hold the date and time
      */
     void getLastModifiedDate(const std::string& fname, DateTime& dt);
+#if defined(_WIN32) // Windows
     /**
-     * @brief Check if a file has empty line at the end (ends with '\n')
+     * @brief Get the last modification date of the opened file.
+     * A date and time returned by the function is a local time
      *
-     * @param fname Path to the file
-     * @return true if a file has empty line at the end, false otherwise
+     * @param hFile Handle to the file
+     * @param dt Object of the class that will hold the date and time
+     */
+    void getLastModifiedDate(HANDLE hFile, DateTime& dt);
+#else // POSIX
+    /**
+     * @brief Get the last modification date from attributes of the file.
+     * A date and time returned by the function is a local time
+     *
+     * @param attr Attributes of the file
+     * @param dt Object of the class that will hold the date and time
+     */
+    void getLastModifiedDate(const struct stat& attr, DateTime& dt);
+#endif // _WIN32
+    /**
+     * @brief Check if the path refers to a directory
+     *
+     * @param path Path
+     * @return true if the path is a directory, false otherwise
+     */
+    bool isDirectory(const std::string& path);
+    /**
+     * @brief List files in the directory and all its subdirectories.
+     * Paths are relative to the directory, use '/' as a separator
+     * and are sorted. Links to directories are not followed,
+     * so that cycles are not possible
+     *
+     * @param dir Path to the directory
+     * @param files Vector that receives paths of files
      */
-    bool hasEndingNewLine(const std::string& fname);
+    void listFiles(const std::string& dir, std::vector<std::string>& files);
 }
 
 #endif // FILE_HELPER_H
\ No newline at end of file
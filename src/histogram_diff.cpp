@@ -0,0 +1,219 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "histogram_diff.h"
+
+#include <algorithm>
+
+/**
+ * @brief Initialize parameters with specified values
+ *
+ * @param original IDs of lines from the original file
+ * @param modified IDs of lines from the modified file
+ * @param idCount Number of unique IDs in both files
+ */
+HistogramDiff::HistogramDiff(const std::vector<std::uint32_t>& original,
+                             const std::vector<std::uint32_t>& modified,
+                             std::uint32_t idCount) :
+                             MAX_CHAIN_LENGTH(64),
+                             original(original),
+                             modified(modified),
+                             myers(original, modified),
+                             count(idCount, 0),
+                             head(idCount, -1),
+                             next(original.size(), -1) { }
+
+/**
+ * @brief Find the longest common region around
+ * the line with the lowest number of occurrences
+ *
+ * @param aLo Start of the range in the original file
+ * @param aHi End of the range in the original file
+ * @param bLo Start of the range in the modified file
+ * @param bHi End of the range in the modified file
+ * @param x Start of the region in the original file
+ * @param y Start of the region in the modified file
+ * @param length Length of the region, 0 if there are no common lines
+ * @return true if the region was found or there are no common lines,
+ * false if all common lines are too frequent
+ */
+bool HistogramDiff::findRegion(int aLo, int aHi, int bLo, int bHi,
+                               int& x, int& y, int& length)
+{
+    // Lowest number of occurrences within the best region
+    std::uint32_t lowest = MAX_CHAIN_LENGTH + 1;
+    // Whether there is at least one common line
+    bool hasCommon = false;
+    std::uint32_t rc;
+    int i, j, as, ae, bs, be, bNext;
+
+    length = 0;
+
+    // Build the histogram of the original range. Chains are built
+    // from the end, so they list positions in ascending order
+    for(i = aHi - 1; i >= aLo; i--)
+    {
+        count[original[i]]++;
+        next[i] = head[original[i]];
+        head[original[i]] = i;
+    }
+
+    for(j = bLo; j < bHi; j = bNext)
+    {
+        bNext = j + 1;
+
+        // Line does not occur in the original range or occurs
+        // more often than the line of the best region
+        if(count[modified[j]] == 0 ||
+           (hasCommon && count[modified[j]] > lowest))
+            continue;
+
+        hasCommon = true;
+
+        for(i = head[modified[j]]; i != -1; i = next[i])
+        {
+            as = i;
+            ae = i + 1;
+            bs = j;
+            be = j + 1;
+            rc = count[modified[j]];
+
+            // Extend the region backward
+            while(as > aLo && bs > bLo && original[as - 1] == modified[bs - 1])
+            {
+                as--;
+                bs--;
+                rc = std::min(rc, count[original[as]]);
+            }
+
+            // Extend the region forward
+            while(ae < aHi && be < bHi && original[ae] == modified[be])
+            {
+                rc = std::min(rc, count[original[ae]]);
+                ae++;
+                be++;
+            }
+
+            // Lines of the region do not have to be checked again
+            if(bNext < be) bNext = be;
+
+            if(length < ae - as || rc < lowest)
+            {
+                x = as;
+                y = bs;
+                length = ae - as;
+                lowest = rc;
+            }
+        }
+    }
+
+    // Reset the histogram for the next range
+    for(i = aLo; i < aHi; i++)
+    {
+        count[original[i]] = 0;
+        head[original[i]] = -1;
+    }
+
+    return !hasCommon || lowest <= MAX_CHAIN_LENGTH;
+}
+
+/**
+ * @brief Calculate the difference between ranges of two sequences.
+ * Only flags of lines within the ranges are changed
+ *
+ * @param aLo Start of the range in the original file
+ * @param aHi End of the range in the original file
+ * @param bLo Start of the range in the modified file
+ * @param bHi End of the range in the modified file
+ * @param removed Flags of removed lines in the original file
+ * @param inserted Flags of inserted lines in the modified file
+ */
+void HistogramDiff::calculate(int aLo, int aHi, int bLo, int bHi,
+                              std::vector<char>& removed,
+                              std::vector<char>& inserted)
+{
+    // Ranges that still have to be solved. A stack is used
+    // instead of recursion, so deep nesting of regions
+    // cannot overflow the call stack
+    std::vector<int> ranges = { aLo, aHi, bLo, bHi };
+    int x = 0, y = 0, length;
+
+    while(!ranges.empty())
+    {
+        bHi = ranges.back(); ranges.pop_back();
+        bLo = ranges.back(); ranges.pop_back();
+        aHi = ranges.back(); ranges.pop_back();
+        aLo = ranges.back(); ranges.pop_back();
+
+        // Skip unchanged lines at the start of both ranges
+        while(aLo < aHi && bLo < bHi && original[aLo] == modified[bLo])
+        {
+            aLo++;
+            bLo++;
+        }
+
+        // Skip unchanged lines at the end of both ranges
+        while(aLo < aHi && bLo < bHi && original[aHi - 1] == modified[bHi - 1])
+        {
+            aHi--;
+            bHi--;
+        }
+
+        if(aLo == aHi) // All remaining lines were inserted
+        {
+            std::fill(inserted.begin() + bLo, inserted.begin() + bHi, 1);
+        }
+        else if(bLo == bHi) // All remaining lines were removed
+        {
+            std::fill(removed.begin() + aLo, removed.begin() + aHi, 1);
+        }
+        else if(!findRegion(aLo, aHi, bLo, bHi, x, y, length))
+        {
+            // Common lines are too frequent to split on
+            myers.calculate(aLo, aHi, bLo, bHi, removed, inserted);
+        }
+        else if(length == 0) // Ranges have nothing in common
+        {
+            std::fill(removed.begin() + aLo, removed.begin() + aHi, 1);
+            std::fill(inserted.begin() + bLo, inserted.begin() + bHi, 1);
+        }
+        else
+        {
+            // Solve both sides of the region. Region itself is unchanged
+            ranges.insert(ranges.end(), { aLo, x, bLo, y });
+            ranges.insert(ranges.end(), { x + length, aHi, y + length, bHi });
+        }
+    }
+}
+
+/**
+ * @brief Set the number of steps of the Myers search for ranges
+ * that cannot be split, after which the shortest edit script
+ * is no longer searched for
+ *
+ * @param costLimit Maximum number of steps, INT_MAX for the exact search
+ */
+void HistogramDiff::setCostLimit(int costLimit)
+{
+    myers.setCostLimit(costLimit);
+}
\ No newline at end of file
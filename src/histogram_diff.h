@@ -0,0 +1,134 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HISTOGRAM_DIFF_H
+#define HISTOGRAM_DIFF_H
+
+#include <cstdint>
+#include <vector>
+
+#include "myers_diff.h"
+
+/**
+ * @brief Class for calculating the difference between two sequences
+ * using the histogram algorithm (as in git and JGit). The longest common
+ * region built around the line with the lowest number of occurrences is
+ * matched and both sides of it are solved recursively. Unlike the patience
+ * algorithm it can split on lines that are not unique, so it also works
+ * on files with many repeated lines
+ *
+ */
+class HistogramDiff
+{
+    private:
+        /**
+         * @brief Lines that occur more often than this in the original range
+         * are not used for splitting. If there are no other common lines,
+         * the range is solved with the Myers algorithm
+         *
+         */
+        const std::uint32_t MAX_CHAIN_LENGTH;
+        /**
+         * @brief IDs of lines from the original file
+         *
+         */
+        const std::vector<std::uint32_t>& original;
+        /**
+         * @brief IDs of lines from the modified file
+         *
+         */
+        const std::vector<std::uint32_t>& modified;
+        /**
+         * @brief Algorithm for ranges with only frequent common lines
+         *
+         */
+        MyersDiff myers;
+        /**
+         * @brief Number of occurrences of each ID in the original range
+         *
+         */
+        std::vector<std::uint32_t> count;
+        /**
+         * @brief Last position of each ID in the original range, or -1
+         *
+         */
+        std::vector<int> head;
+        /**
+         * @brief Previous position of the same ID for each position
+         * in the original range, or -1
+         *
+         */
+        std::vector<int> next;
+        /**
+         * @brief Find the longest common region around
+         * the line with the lowest number of occurrences
+         *
+         * @param aLo Start of the range in the original file
+         * @param aHi End of the range in the original file
+         * @param bLo Start of the range in the modified file
+         * @param bHi End of the range in the modified file
+         * @param x Start of the region in the original file
+         * @param y Start of the region in the modified file
+         * @param length Length of the region, 0 if there are no common lines
+         * @return true if the region was found or there are no common lines,
+         * false if all common lines are too frequent
+         */
+        bool findRegion(int aLo, int aHi, int bLo, int bHi,
+                        int& x, int& y, int& length);
+
+    public:
+        /**
+         * @brief Initialize parameters with specified values
+         *
+         * @param original IDs of lines from the original file
+         * @param modified IDs of lines from the modified file
+         * @param idCount Number of unique IDs in both files
+         */
+        HistogramDiff(const std::vector<std::uint32_t>& original,
+                      const std::vector<std::uint32_t>& modified,
+                      std::uint32_t idCount);
+        /**
+         * @brief Calculate the difference between ranges of two sequences.
+         * Only flags of lines within the ranges are changed
+         *
+         * @param aLo Start of the range in the original file
+         * @param aHi End of the range in the original file
+         * @param bLo Start of the range in the modified file
+         * @param bHi End of the range in the modified file
+         * @param removed Flags of removed lines in the original file
+         * @param inserted Flags of inserted lines in the modified file
+         */
+        void calculate(int aLo, int aHi, int bLo, int bHi,
+                       std::vector<char>& removed,
+                       std::vector<char>& inserted);
+        /**
+         * @brief Set the number of steps of the Myers search for ranges
+         * that cannot be split, after which the shortest edit script
+         * is no longer searched for
+         *
+         * @param costLimit Maximum number of steps, INT_MAX for the exact search
+         */
+        void setCostLimit(int costLimit);
+};
+
+#endif // HISTOGRAM_DIFF_H
\ No newline at end of file
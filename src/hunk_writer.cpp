@@ -0,0 +1,234 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "hunk_writer.h"
+
+#include <algorithm>
+
+/**
+ * @brief Initialize the writer
+ *
+ * @param out Output sink
+ * @param ch Color handler or nullptr if colors are not used
+ * @param context Number of context lines
+ * @param maxHunkLength Hunks longer than this are written right away
+ */
+HunkWriter::HunkWriter(OutputSink& out, const ColorHandler* ch,
+                       unsigned int context, std::size_t maxHunkLength) :
+    out(out),                       // Output sink
+    ch(ch),                         // Color handler
+    context(context),               // Number of context lines
+    maxHunkLength(maxHunkLength),   // Limit of lines kept in memory
+    leading(),                      // Context before the next hunk
+    changes(),                      // Lines of the current hunk
+    lines(),
+    incomplete(),
+    trailing(0),                    // Unchanged lines at the end of the hunk
+    open(false),                    // Opened by the first change
+    split(false),                   // Set when the hunk is too long
+    lineOld(0),                     // Nothing is written yet
+    lineNew(0),
+    hunkOld(0),                     // Set when the hunk starts
+    hunkNew(0) { }
+
+/**
+ * @brief Write the first lines of the current hunk and remove them.
+ * Parts of a split hunk are written without context
+ *
+ * @param count Number of lines to write
+ */
+void HunkWriter::writeHunk(std::size_t count)
+{
+    std::size_t first = 0; // First line to write
+    std::size_t last = count; // Line after the last one to write
+    unsigned int skipped = 0; // Number of context lines before the first line
+    unsigned int linesOld = 0; // Number of lines in the original file
+    unsigned int linesNew = 0; // Number of lines in the modified file
+    std::size_t i;
+
+    // Context on only one side would tie the part of the hunk
+    // to the start or the end of the file
+    if(split)
+    {
+        while(first < last && changes[first] == Change::Equal) first++;
+        while(last > first && changes[last - 1] == Change::Equal) last--;
+        skipped = first;
+    }
+
+    for(i = first; i < last; i++)
+    {
+        if(changes[i] != Change::Insert) linesOld++;
+        if(changes[i] != Change::Remove) linesNew++;
+    }
+
+    if(first < last)
+    {
+        // Output range information. An empty range refers
+        // to the line right before the hunk
+
+        if(ch) ch->setColor(Color::Magenta);
+
+        out << "@@ -"
+            << hunkOld + skipped + (linesOld > 0 ? 1 : 0) // Starting line in the original file
+            << ','
+            << linesOld
+            << " +"
+            << hunkNew + skipped + (linesNew > 0 ? 1 : 0) // Starting line in the modified file
+            << ','
+            << linesNew
+            << " @@\n";
+
+        if(ch) ch->resetColor();
+    }
+
+    // Output the hunk
+
+    for(i = first; i < last; i++)
+    {
+        if(changes[i] == Change::Remove) // Line is removed
+        {
+            if(ch) ch->setColor(Color::Red);
+            out << '-' << lines[i] << '\n';
+            if(ch) ch->resetColor();
+        }
+        else if(changes[i] == Change::Insert) // Line is inserted
+        {
+            if(ch) ch->setColor(Color::Green);
+            out << '+' << lines[i] << '\n';
+            if(ch) ch->resetColor();
+        }
+        else // Unchanged line
+        {
+            out << ' ' << lines[i] << '\n';
+        }
+
+        if(incomplete[i])
+            out << "\\ No newline at end of file\n";
+    }
+
+    // Remaining lines start the next part of the hunk
+    for(i = 0; i < count; i++)
+    {
+        if(changes[i] != Change::Insert) hunkOld++;
+        if(changes[i] != Change::Remove) hunkNew++;
+    }
+
+    changes.erase(changes.begin(), changes.begin() + count);
+    lines.erase(lines.begin(), lines.begin() + count);
+    incomplete.erase(incomplete.begin(), incomplete.begin() + count);
+}
+
+/**
+ * @brief Add the next line of the edit script
+ *
+ * @param change Type of change
+ * @param line Line
+ * @param noNewLine Whether the line is the last line
+ * of a file that does not end with a new line
+ */
+void HunkWriter::add(Change change, const std::string& line, bool noNewLine)
+{
+    if(change != Change::Insert) lineOld++;
+    if(change != Change::Remove) lineNew++;
+
+    if(change == Change::Equal)
+    {
+        if(!open)
+        {
+            // No hunk is open, keep the line as possible context
+            leading.push_back(line);
+            if(leading.size() > context) leading.pop_front();
+            return;
+        }
+
+        changes.push_back(change);
+        lines.push_back(line);
+        incomplete.push_back(noNewLine);
+        trailing++;
+
+        // Hunks separated by more than twice the number
+        // of context lines are not merged
+        if(trailing > 2 * context)
+        {
+            writeHunk(changes.size() - trailing + context);
+
+            // Context after the hunk becomes context before the next one
+            leading.assign(lines.end() - std::min<std::size_t>(context, lines.size()), lines.end());
+            changes.clear();
+            lines.clear();
+            incomplete.clear();
+            trailing = 0;
+            open = false;
+            split = false;
+        }
+
+        return;
+    }
+
+    if(!open)
+    {
+        // Start the hunk with the context before it
+        hunkOld = lineOld - (change == Change::Remove ? 1 : 0) - leading.size();
+        hunkNew = lineNew - (change == Change::Insert ? 1 : 0) - leading.size();
+        open = true;
+
+        for(const std::string& contextLine : leading)
+        {
+            changes.push_back(Change::Equal);
+            lines.push_back(contextLine);
+            incomplete.push_back(0);
+        }
+
+        leading.clear();
+    }
+
+    changes.push_back(change);
+    lines.push_back(line);
+    incomplete.push_back(noNewLine);
+    trailing = 0;
+
+    // Very long hunks are written in parts to keep memory usage bounded
+    if(changes.size() >= maxHunkLength)
+    {
+        split = true;
+        writeHunk(changes.size());
+    }
+}
+
+/**
+ * @brief Write the last hunk
+ *
+ */
+void HunkWriter::finish(void)
+{
+    if(!open) return;
+
+    // Keep only the context after the last change
+    writeHunk(changes.size() - trailing + std::min(trailing, context));
+    changes.clear();
+    lines.clear();
+    incomplete.clear();
+    trailing = 0;
+    open = false;
+    split = false;
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef HUNK_WRITER_H
+#define HUNK_WRITER_H
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "color_handler.h"
+#include "diff_item.h"
+#include "output_sink.h"
+
+/**
+ * @brief Class that writes lines of the edit script in unified format as
+ * they arrive, without knowing the whole script. Only the current hunk
+ * and the context before it are kept in memory
+ *
+ */
+class HunkWriter
+{
+    private:
+        /**
+         * @brief Output sink
+         *
+         */
+        OutputSink& out;
+        /**
+         * @brief Color handler or nullptr if colors are not used
+         *
+         */
+        const ColorHandler* ch;
+        /**
+         * @brief Number of context lines
+         *
+         */
+        const unsigned int context;
+        /**
+         * @brief Hunks longer than this are written right away
+         *
+         */
+        const std::size_t maxHunkLength;
+        /**
+         * @brief Unchanged lines that may become context before the next hunk
+         *
+         */
+        std::deque<std::string> leading;
+        /**
+         * @brief Type of change of each line in the current hunk
+         *
+         */
+        std::vector<Change> changes;
+        /**
+         * @brief Each line in the current hunk
+         *
+         */
+        std::vector<std::string> lines;
+        /**
+         * @brief Whether each line in the current hunk is the last
+         * line of a file that does not end with a new line
+         *
+         */
+        std::vector<char> incomplete;
+        /**
+         * @brief Number of unchanged lines at the end of the current hunk
+         *
+         */
+        unsigned int trailing;
+        /**
+         * @brief Whether a hunk is open
+         *
+         */
+        bool open;
+        /**
+         * @brief Whether the open hunk was too long and is written in parts
+         *
+         */
+        bool split;
+        /**
+         * @brief Number of lines of the original file written so far
+         *
+         */
+        unsigned int lineOld;
+        /**
+         * @brief Number of lines of the modified file written so far
+         *
+         */
+        unsigned int lineNew;
+        /**
+         * @brief Position of the current hunk in the original file
+         *
+         */
+        unsigned int hunkOld;
+        /**
+         * @brief Position of the current hunk in the modified file
+         *
+         */
+        unsigned int hunkNew;
+        /**
+         * @brief Write the first lines of the current hunk and remove them.
+         * Parts of a split hunk are written without context
+         *
+         * @param count Number of lines to write
+         */
+        void writeHunk(std::size_t count);
+
+    public:
+        /**
+         * @brief Initialize the writer
+         *
+         * @param out Output sink
+         * @param ch Color handler or nullptr if colors are not used
+         * @param context Number of context lines
+         * @param maxHunkLength Hunks longer than this are written right away
+         */
+        HunkWriter(OutputSink& out, const ColorHandler* ch,
+                   unsigned int context, std::size_t maxHunkLength);
+        /**
+         * @brief Add the next line of the edit script
+         *
+         * @param change Type of change
+         * @param line Line
+         * @param noNewLine Whether the line is the last line
+         * of a file that does not end with a new line
+         */
+        void add(Change change, const std::string& line, bool noNewLine);
+        /**
+         * @brief Write the last hunk
+         *
+         */
+        void finish(void);
+};
+
+#endif // HUNK_WRITER_H
\ No newline at end of file
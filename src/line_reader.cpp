@@ -0,0 +1,292 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "line_reader.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include "file_helper.h"
+
+#if defined(_WIN32) // Windows
+#include <fcntl.h>
+#include <io.h>
+#else // POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif // _WIN32
+
+/**
+ * @brief Open the file and check if it is compressed
+ *
+ * @param fname Filename
+ * @param method Method of reading the file
+ * @param stripCarriageReturns Whether to remove "\r"
+ * from lines that end with "\r\n"
+ */
+LineReader::LineReader(const std::string& fname, ReadMethod method, bool stripCarriageReturns) :
+    filename(fname),        // Path to the file
+    lastModified(),         // Taken from the opened file
+    fd(-1),                 // Opened below
+    blockReader(),          // Created when the file is opened
+    buffer(),               // Allocated only for compressed files
+    decompressor(),         // Created only for compressed files
+    chunk(nullptr),         // Nothing is read yet
+    position(0),            // Chunk is empty
+    length(0),              // Chunk is empty
+    endingNewLine(true),    // Set when the last line is read
+    stripCarriageReturns(stripCarriageReturns) // Whether "\r" is removed
+{
+#if defined(_WIN32) // Windows
+    fd = _open(fname.c_str(), _O_RDONLY | _O_BINARY);
+
+    if(fd == -1)
+        throw std::runtime_error("could not open " + fname);
+
+    try
+    {
+        FileHelper::getLastModifiedDate(fname, lastModified);
+    }
+    catch(...)
+    {
+        _close(fd);
+        throw;
+    }
+#else // POSIX
+    fd = open(fname.c_str(), O_RDONLY);
+
+    if(fd == -1)
+        throw std::runtime_error("could not open " + fname);
+
+    struct stat fileStat;
+
+    try
+    {
+        if(fstat(fd, &fileStat) == -1)
+            throw std::runtime_error("could not get last modification date of " + fname);
+
+        FileHelper::getLastModifiedDate(fileStat, lastModified);
+    }
+    catch(...)
+    {
+        close(fd);
+        throw;
+    }
+#endif // _WIN32
+
+    try
+    {
+        blockReader.reset(new BlockReader(fd, fname, method == ReadMethod::IoUring));
+        detectCompression();
+    }
+    catch(...)
+    {
+        // Reads in flight must complete before the file is closed
+        blockReader.reset();
+
+#if defined(_WIN32) // Windows
+        _close(fd);
+#else // POSIX
+        close(fd);
+#endif // _WIN32
+        throw;
+    }
+}
+
+/**
+ * @brief Close the file
+ *
+ */
+LineReader::~LineReader(void)
+{
+    // Reads in flight must complete before the file is closed
+    blockReader.reset();
+
+#if defined(_WIN32) // Windows
+    _close(fd);
+#else // POSIX
+    close(fd);
+#endif // _WIN32
+}
+
+/**
+ * @brief Check the first bytes of the file for compression
+ *
+ */
+void LineReader::detectCompression(void)
+{
+    // Blocks are full except the last one, so the magic
+    // number is always within the first block
+    if(!blockReader->next(chunk, length)) return;
+
+    if(Decompressor::isZstd(chunk, length))
+        throw std::runtime_error(filename + " is compressed with zstd, which is not supported");
+
+    if(!Decompressor::isGzip(chunk, length)) return;
+
+    // The block is consumed by the decompressor,
+    // lines are split in decompressed data
+    decompressor.reset(new Decompressor(filename));
+    decompressor->setInput(chunk, length);
+    buffer.resize(BUFFER_SIZE);
+    chunk = buffer.data();
+    length = 0;
+}
+
+/**
+ * @brief Get the next part of the file as the chunk
+ *
+ * @return true if anything was read, false at the end of the file
+ */
+bool LineReader::fillBuffer(void)
+{
+    const char* block;
+    std::size_t count;
+
+    position = 0;
+
+    if(!decompressor)
+    {
+        if(blockReader->next(chunk, length)) return true;
+
+        length = 0;
+        return false;
+    }
+
+    while(true)
+    {
+        length = decompressor->decompress(buffer.data(), buffer.size());
+
+        if(length > 0) return true;
+
+        // The previous block is consumed, so it can be released
+        if(!blockReader->next(block, count))
+        {
+            if(!decompressor->isFinished())
+                throw std::runtime_error("unexpected end of compressed file " + filename);
+
+            return false;
+        }
+
+        decompressor->setInput(block, count);
+    }
+}
+
+/**
+ * @brief Read the next line without the line terminator
+ *
+ * @param line String that receives the line
+ * @return true if the line was read, false at the end of the file
+ */
+bool LineReader::readLine(std::string& line)
+{
+    const char* newline;
+
+    line.clear();
+
+    while(true)
+    {
+        if(position == length && !fillBuffer())
+        {
+            // The last line does not end with a new line
+            if(line.empty()) return false;
+
+            endingNewLine = false;
+            return true;
+        }
+
+        newline = static_cast<const char*>(std::memchr(
+            chunk + position, '\n', length - position));
+
+        if(newline != nullptr)
+        {
+            line.append(chunk + position, newline - chunk - position);
+            position = newline - chunk + 1;
+
+            if(stripCarriageReturns && !line.empty() && line.back() == '\r')
+                line.pop_back();
+
+            return true;
+        }
+
+        // The line continues in the next part of the file
+        line.append(chunk + position, length - position);
+        position = length;
+    }
+}
+
+/**
+ * @brief Check if the file looks binary, i.e. the unread part
+ * of the chunk contains a null byte. It is meant to be called
+ * before reading lines, so that the beginning of the file is checked
+ *
+ * @return true if the file is binary, false otherwise
+ */
+bool LineReader::isBinary(void)
+{
+    if(position == length && !fillBuffer()) return false;
+
+    return std::memchr(chunk + position, '\0', length - position) != nullptr;
+}
+
+/**
+ * @brief Check if there are no more lines to read
+ *
+ * @return true if the end of the file is reached, false otherwise
+ */
+bool LineReader::isAtEnd(void)
+{
+    return position == length && !fillBuffer();
+}
+
+/**
+ * @brief Get the path to the file
+ *
+ * @return Path to the file
+ */
+const std::string& LineReader::getFilename(void) const
+{
+    return filename;
+}
+
+/**
+ * @brief Get the last modification date of the file
+ *
+ * @return Last modification date of the file
+ */
+DateTime LineReader::getLastModified(void) const
+{
+    return lastModified;
+}
+
+/**
+ * @brief Check if the file ends with a new line. The result
+ * is known only after the end of the file is reached
+ *
+ * @return true if the file ends with a new line, false otherwise
+ */
+bool LineReader::hasEndingNewLine(void) const
+{
+    return endingNewLine;
+}
\ No newline at end of file
@@ -0,0 +1,183 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LINE_READER_H
+#define LINE_READER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "block_reader.h"
+#include "date_time.h"
+#include "decompressor.h"
+#include "options.h"
+
+/**
+ * @brief Class for reading a file line by line through fixed-size blocks,
+ * so that memory usage does not depend on the size of the file.
+ * Lines are split directly in blocks of the file. Compressed files
+ * are decompressed on the fly
+ *
+ */
+class LineReader
+{
+    private:
+        /**
+         * @brief Size of the buffer for decompressed contents in bytes
+         *
+         */
+        static const std::size_t BUFFER_SIZE = 65536;
+        /**
+         * @brief Path to the file
+         *
+         */
+        std::string filename;
+        /**
+         * @brief Last modification date of the file
+         *
+         */
+        DateTime lastModified;
+        /**
+         * @brief File descriptor
+         *
+         */
+        int fd;
+        /**
+         * @brief Reader of raw contents of the file
+         *
+         */
+        std::unique_ptr<BlockReader> blockReader;
+        /**
+         * @brief Buffer for decompressed contents
+         *
+         */
+        std::vector<char> buffer;
+        /**
+         * @brief Decompressor, if the file is compressed
+         *
+         */
+        std::unique_ptr<Decompressor> decompressor;
+        /**
+         * @brief Contents that are split into lines, either
+         * the current block of the file or decompressed data
+         *
+         */
+        const char* chunk;
+        /**
+         * @brief Position of the first unread byte in the chunk
+         *
+         */
+        std::size_t position;
+        /**
+         * @brief Number of bytes in the chunk
+         *
+         */
+        std::size_t length;
+        /**
+         * @brief Whether the file ends with a new line
+         *
+         */
+        bool endingNewLine;
+        /**
+         * @brief Whether "\r" is removed from lines that end with "\r\n"
+         *
+         */
+        bool stripCarriageReturns;
+        /**
+         * @brief Check the first bytes of the file for compression
+         *
+         */
+        void detectCompression(void);
+        /**
+         * @brief Get the next part of the file as the chunk
+         *
+         * @return true if anything was read, false at the end of the file
+         */
+        bool fillBuffer(void);
+
+    public:
+        /**
+         * @brief Open the file and check if it is compressed
+         *
+         * @param fname Filename
+         * @param method Method of reading the file
+         * @param stripCarriageReturns Whether to remove "\r"
+         * from lines that end with "\r\n"
+         */
+        LineReader(const std::string& fname, ReadMethod method, bool stripCarriageReturns);
+        /**
+         * @brief Close the file
+         *
+         */
+        ~LineReader(void);
+        /**
+         * @brief Reader owns the file descriptor, so it cannot be copied
+         *
+         */
+        LineReader(const LineReader&) = delete;
+        LineReader& operator=(const LineReader&) = delete;
+        /**
+         * @brief Read the next line without the line terminator
+         *
+         * @param line String that receives the line
+         * @return true if the line was read, false at the end of the file
+         */
+        bool readLine(std::string& line);
+        /**
+         * @brief Check if the file looks binary, i.e. the unread part
+         * of the chunk contains a null byte. It is meant to be called
+         * before reading lines, so that the beginning of the file is checked
+         *
+         * @return true if the file is binary, false otherwise
+         */
+        bool isBinary(void);
+        /**
+         * @brief Check if there are no more lines to read
+         *
+         * @return true if the end of the file is reached, false otherwise
+         */
+        bool isAtEnd(void);
+        /**
+         * @brief Get the path to the file
+         *
+         * @return Path to the file
+         */
+        const std::string& getFilename(void) const;
+        /**
+         * @brief Get the last modification date of the file
+         *
+         * @return Last modification date of the file
+         */
+        DateTime getLastModified(void) const;
+        /**
+         * @brief Check if the file ends with a new line. The result
+         * is known only after the end of the file is reached
+         *
+         * @return true if the file ends with a new line, false otherwise
+         */
+        bool hasEndingNewLine(void) const;
+};
+
+#endif // LINE_READER_H
\ No newline at end of file
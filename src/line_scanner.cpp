@@ -0,0 +1,235 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "line_scanner.h"
+
+#include <algorithm>
+#include <cstring>
+
+// SIMD is available only on x86 processors
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LINE_SCANNER_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Initialize the scanner
+ *
+ * @param stripCarriageReturns Whether to remove "\r"
+ * from lines that end with "\r\n"
+ */
+LineScanner::LineScanner(bool stripCarriageReturns) :
+    stripCarriageReturns(stripCarriageReturns), // Whether "\r" is removed
+    carriageReturns(false), // Set when a line ends with "\r\n"
+    endingNewLine(true) { } // Empty buffer has nothing to terminate
+
+/**
+ * @brief Add the line that ends at the new line character
+ *
+ * @param begin Start of the line, moved past the new line
+ * @param newline Position of the new line character
+ * @param lines Vector that receives the line
+ */
+inline void LineScanner::addLine(const char*& begin, const char* newline,
+                                 std::vector<LineView>& lines)
+{
+    const char* end = newline;
+
+    if(newline != begin && newline[-1] == '\r')
+    {
+        carriageReturns = true;
+
+        if(stripCarriageReturns) end--;
+    }
+
+    lines.push_back(LineView(begin, end - begin));
+    begin = newline + 1;
+}
+
+/**
+ * @brief Find new lines one character at a time
+ *
+ * @param begin Start of the current line
+ * @param end End of the buffer
+ * @param lines Vector that receives lines
+ */
+void LineScanner::scanScalar(const char*& begin, const char* end,
+                             std::vector<LineView>& lines)
+{
+    const void* newline;
+
+    while(begin != end && (newline = std::memchr(begin, '\n', end - begin)) != nullptr)
+        addLine(begin, static_cast<const char*>(newline), lines);
+}
+
+/**
+ * @brief Find new lines 16 bytes at a time
+ *
+ * @param begin Start of the current line
+ * @param end End of the buffer
+ * @param lines Vector that receives lines
+ */
+void LineScanner::scanSse2(const char*& begin, const char* end,
+                           std::vector<LineView>& lines)
+{
+#if defined(LINE_SCANNER_X86) && defined(__SSE2__)
+    const __m128i newlines = _mm_set1_epi8('\n');
+    const char* block = begin;
+    unsigned int mask;
+
+    for(; end - block >= 16; block += 16)
+    {
+        // One bit for each new line in the block
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi8(newlines,
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(block))));
+
+        while(mask != 0)
+        {
+            addLine(begin, block + __builtin_ctz(mask), lines);
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    // Remaining bytes
+    scanScalar(begin, end, lines);
+}
+
+/**
+ * @brief Find new lines 32 bytes at a time
+ *
+ * @param begin Start of the current line
+ * @param end End of the buffer
+ * @param lines Vector that receives lines
+ */
+#if defined(LINE_SCANNER_X86)
+__attribute__((target("avx2")))
+#endif
+void LineScanner::scanAvx2(const char*& begin, const char* end,
+                           std::vector<LineView>& lines)
+{
+#if defined(LINE_SCANNER_X86)
+    const __m256i newlines = _mm256_set1_epi8('\n');
+    const char* block = begin;
+    unsigned int mask;
+
+    for(; end - block >= 32; block += 32)
+    {
+        // One bit for each new line in the block
+        mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(newlines,
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block))));
+
+        while(mask != 0)
+        {
+            addLine(begin, block + __builtin_ctz(mask), lines);
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    // Remaining bytes
+    scanScalar(begin, end, lines);
+}
+
+/**
+ * @brief Split the buffer into lines. Line terminators
+ * are not included in lines
+ *
+ * @param data Pointer to the first byte of the buffer
+ * @param size Size of the buffer in bytes
+ * @param lines Vector that receives lines from the buffer,
+ * its previous contents are removed
+ */
+void LineScanner::scan(const char* data, std::size_t size, std::vector<LineView>& lines)
+{
+    lines.clear();
+    carriageReturns = false;
+    endingNewLine = true;
+
+    if(size == 0) return;
+
+    const char* begin = data;
+    const char* end = data + size;
+
+    // Growing the vector costs more than the search itself, so the number
+    // of lines is estimated from chunks spread over the whole buffer,
+    // because lengths of lines at the head often differ from the rest
+    const std::size_t sampled = SAMPLE_COUNT * SAMPLE_SIZE;
+    std::size_t count = 0, i, offset;
+
+    if(size <= sampled)
+    {
+        count = std::count(data, end, '\n');
+        lines.reserve(count + 1);
+    }
+    else
+    {
+        for(i = 0; i < SAMPLE_COUNT; i++)
+        {
+            offset = (size - SAMPLE_SIZE) / (SAMPLE_COUNT - 1) * i;
+            count += std::count(data + offset, data + offset + SAMPLE_SIZE, '\n');
+        }
+
+        lines.reserve(size / sampled * count + count + 1);
+    }
+
+#if defined(LINE_SCANNER_X86)
+    // Processor is checked only once
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+
+    if(avx2)
+        scanAvx2(begin, end, lines);
+    else
+        scanSse2(begin, end, lines);
+#else
+    scanScalar(begin, end, lines);
+#endif
+
+    // The last line may not end with a new line
+    if(begin != end)
+    {
+        lines.push_back(LineView(begin, end - begin));
+        endingNewLine = false;
+    }
+}
+
+/**
+ * @brief Check if any line of the last scanned buffer ends with "\r\n"
+ *
+ * @return true if any line ends with "\r\n", false otherwise
+ */
+bool LineScanner::hasCarriageReturns(void) const
+{
+    return carriageReturns;
+}
+
+/**
+ * @brief Check if the last scanned buffer ends with a new line.
+ * Empty buffers are considered to end with a new line
+ *
+ * @return true if the buffer ends with a new line, false otherwise
+ */
+bool LineScanner::hasEndingNewLine(void) const
+{
+    return endingNewLine;
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LINE_SCANNER_H
+#define LINE_SCANNER_H
+
+#include <cstddef>
+#include <vector>
+
+#include "line_view.h"
+
+/**
+ * @brief Class that splits a buffer into lines in a single pass.
+ * New lines are searched with SIMD instructions when the processor
+ * supports them
+ *
+ */
+class LineScanner
+{
+    private:
+        /**
+         * @brief Number of chunks sampled to estimate the number of lines
+         *
+         */
+        static const std::size_t SAMPLE_COUNT = 16;
+        /**
+         * @brief Size of each sampled chunk in bytes
+         *
+         */
+        static const std::size_t SAMPLE_SIZE = 4096;
+        /**
+         * @brief Whether "\r" is removed from lines that end with "\r\n"
+         *
+         */
+        bool stripCarriageReturns;
+        /**
+         * @brief Whether any line ends with "\r\n"
+         *
+         */
+        bool carriageReturns;
+        /**
+         * @brief Whether the last line ends with a new line
+         *
+         */
+        bool endingNewLine;
+        /**
+         * @brief Add the line that ends at the new line character
+         *
+         * @param begin Start of the line, moved past the new line
+         * @param newline Position of the new line character
+         * @param lines Vector that receives the line
+         */
+        void addLine(const char*& begin, const char* newline,
+                     std::vector<LineView>& lines);
+        /**
+         * @brief Find new lines one character at a time
+         *
+         * @param begin Start of the current line
+         * @param end End of the buffer
+         * @param lines Vector that receives lines
+         */
+        void scanScalar(const char*& begin, const char* end,
+                        std::vector<LineView>& lines);
+        /**
+         * @brief Find new lines 16 bytes at a time
+         *
+         * @param begin Start of the current line
+         * @param end End of the buffer
+         * @param lines Vector that receives lines
+         */
+        void scanSse2(const char*& begin, const char* end,
+                      std::vector<LineView>& lines);
+        /**
+         * @brief Find new lines 32 bytes at a time
+         *
+         * @param begin Start of the current line
+         * @param end End of the buffer
+         * @param lines Vector that receives lines
+         */
+        void scanAvx2(const char*& begin, const char* end,
+                      std::vector<LineView>& lines);
+
+    public:
+        /**
+         * @brief Initialize the scanner
+         *
+         * @param stripCarriageReturns Whether to remove "\r"
+         * from lines that end with "\r\n"
+         */
+        explicit LineScanner(bool stripCarriageReturns);
+        /**
+         * @brief Split the buffer into lines. Line terminators
+         * are not included in lines
+         *
+         * @param data Pointer to the first byte of the buffer
+         * @param size Size of the buffer in bytes
+         * @param lines Vector that receives lines from the buffer,
+         * its previous contents are removed
+         */
+        void scan(const char* data, std::size_t size, std::vector<LineView>& lines);
+        /**
+         * @brief Check if any line of the last scanned buffer ends with "\r\n"
+         *
+         * @return true if any line ends with "\r\n", false otherwise
+         */
+        bool hasCarriageReturns(void) const;
+        /**
+         * @brief Check if the last scanned buffer ends with a new line.
+         * Empty buffers are considered to end with a new line
+         *
+         * @return true if the buffer ends with a new line, false otherwise
+         */
+        bool hasEndingNewLine(void) const;
+};
+
+#endif // LINE_SCANNER_H
\ No newline at end of file
@@ -0,0 +1,234 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "line_table.h"
+
+#include <cstring>
+
+/**
+ * @brief Initialize an empty table
+ *
+ */
+LineTable::LineTable(void) :
+    buckets(1024, 0),   // Number of buckets is always a power of two
+    hashes(),           // Hash of the line for each ID
+    lines() { }         // Line for each ID
+
+/**
+ * @brief Remove all lines, keeping allocated memory
+ *
+ */
+void LineTable::clear(void)
+{
+    const std::size_t mask = buckets.size() - 1;
+    std::size_t i;
+
+    // Only used buckets are emptied, so a table that has grown for large
+    // files is cleared quickly after small ones. IDs are removed from the
+    // newest, so buckets probed before each ID still hold older IDs.
+    // Distinct IDs are not in buckets and stop at an empty one
+    for(std::uint32_t id = hashes.size(); id-- > 0;)
+    {
+        for(i = hashes[id] & mask; buckets[i] != 0 && buckets[i] != id + 1; i = (i + 1) & mask);
+
+        buckets[i] = 0;
+    }
+
+    hashes.clear();
+    lines.clear();
+}
+
+/**
+ * @brief Calculate the hash of the line
+ *
+ * @param line Line
+ * @return Hash of the line
+ */
+std::uint64_t LineTable::hash(const LineView& line)
+{
+    const std::uint64_t prime = 0x100000001b3ULL;
+    const char* data = line.getData();
+    std::size_t len = line.getLength();
+    std::uint64_t h = 0xcbf29ce484222325ULL ^ len;
+    std::uint64_t word;
+
+    // Mix 8 bytes at a time
+    while(len >= sizeof(word))
+    {
+        std::memcpy(&word, data, sizeof(word));
+        h = (h ^ word) * prime;
+        h ^= h >> 32;
+        data += sizeof(word);
+        len -= sizeof(word);
+    }
+
+    // Mix the remaining bytes
+    while(len > 0)
+    {
+        h = (h ^ static_cast<unsigned char>(*data)) * prime;
+        data++;
+        len--;
+    }
+
+    return h ^ (h >> 29);
+}
+
+/**
+ * @brief Double the number of buckets and reinsert all IDs
+ *
+ */
+void LineTable::grow(void)
+{
+    std::vector<std::uint32_t> larger(buckets.size() * 2, 0);
+    const std::size_t mask = larger.size() - 1;
+    std::size_t i;
+
+    buckets.swap(larger);
+
+    for(std::uint32_t id = 0; id < hashes.size(); id++)
+    {
+        // Find the first empty bucket
+        for(i = hashes[id] & mask; buckets[i] != 0; i = (i + 1) & mask);
+
+        buckets[i] = id + 1;
+    }
+}
+
+/**
+ * @brief Get the ID of the line, adding the line
+ * to the table if it is not there yet
+ *
+ * @param line Line
+ * @return ID of the line
+ */
+std::uint32_t LineTable::add(const LineView& line)
+{
+    return add(line, hash(line));
+}
+
+/**
+ * @brief Get the ID of the line with the known hash,
+ * adding the line to the table if it is not there yet
+ *
+ * @param line Line
+ * @param h Hash of the line
+ * @return ID of the line
+ */
+std::uint32_t LineTable::add(const LineView& line, std::uint64_t h)
+{
+    const std::size_t mask = buckets.size() - 1;
+    std::size_t i;
+    std::uint32_t id;
+
+    for(i = h & mask; buckets[i] != 0; i = (i + 1) & mask)
+    {
+        id = buckets[i] - 1;
+
+        // Equal hashes do not guarantee equal lines,
+        // so contents are compared as well
+        if(hashes[id] == h && *lines[id] == line)
+            return id;
+    }
+
+    id = hashes.size();
+    buckets[i] = id + 1;
+    hashes.push_back(h);
+    lines.push_back(&line);
+
+    // Keep the load factor below 1/2
+    if(hashes.size() * 2 > buckets.size())
+        grow();
+
+    return id;
+}
+
+/**
+ * @brief Get a new ID for the line that is not shared
+ * with any other line, even with an equal one
+ *
+ * @param line Line
+ * @return ID of the line
+ */
+std::uint32_t LineTable::addDistinct(const LineView& line)
+{
+    // ID is not put into any bucket, so lookups never find it
+    hashes.push_back(hash(line));
+    lines.push_back(&line);
+
+    return hashes.size() - 1;
+}
+
+/**
+ * @brief Get IDs for the range of lines
+ *
+ * @param src Lines
+ * @param first Index of the first line
+ * @param last Index after the last line
+ * @param ids Vector that receives IDs at the same indices as lines
+ */
+void LineTable::add(const std::vector<LineView>& src,
+                    std::size_t first, std::size_t last,
+                    std::vector<std::uint32_t>& ids)
+{
+    for(std::size_t i = first; i < last; i++)
+        ids[i] = add(src[i]);
+}
+
+/**
+ * @brief Get IDs for the range of lines with known hashes
+ *
+ * @param src Lines
+ * @param srcHashes Hashes of lines
+ * @param first Index of the first line
+ * @param last Index after the last line
+ * @param ids Vector that receives IDs at the same indices as lines
+ */
+void LineTable::add(const std::vector<LineView>& src,
+                    const std::vector<std::uint64_t>& srcHashes,
+                    std::size_t first, std::size_t last,
+                    std::vector<std::uint32_t>& ids)
+{
+    for(std::size_t i = first; i < last; i++)
+        ids[i] = add(src[i], srcHashes[i]);
+}
+
+/**
+ * @brief Get the number of unique lines in the table
+ *
+ * @return Number of unique lines
+ */
+std::uint32_t LineTable::size(void) const
+{
+    return hashes.size();
+}
+
+/**
+ * @brief Get the line with the specified ID
+ *
+ * @param id ID of the line
+ * @return Line
+ */
+const LineView& LineTable::getLine(std::uint32_t id) const
+{
+    return *lines[id];
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LINE_TABLE_H
+#define LINE_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "line_view.h"
+
+/**
+ * @brief Table that maps equal lines to the same integer ID, so that
+ * lines can be compared without comparing their contents.
+ * IDs are dense and start from 0
+ *
+ */
+class LineTable
+{
+    private:
+        /**
+         * @brief Open addressing hash table. Each bucket stores
+         * ID + 1 of the line or 0 if the bucket is empty
+         *
+         */
+        std::vector<std::uint32_t> buckets;
+        /**
+         * @brief Hash of the line for each ID
+         *
+         */
+        std::vector<std::uint64_t> hashes;
+        /**
+         * @brief Line for each ID. Lines are not copied, so they
+         * must outlive the table
+         *
+         */
+        std::vector<const LineView*> lines;
+        /**
+         * @brief Double the number of buckets and reinsert all IDs
+         *
+         */
+        void grow(void);
+
+    public:
+        /**
+         * @brief Initialize an empty table
+         *
+         */
+        LineTable(void);
+        /**
+         * @brief Remove all lines, keeping allocated memory
+         *
+         */
+        void clear(void);
+        /**
+         * @brief Calculate the hash of the line
+         *
+         * @param line Line
+         * @return Hash of the line
+         */
+        static std::uint64_t hash(const LineView& line);
+        /**
+         * @brief Get the ID of the line, adding the line
+         * to the table if it is not there yet
+         *
+         * @param line Line
+         * @return ID of the line
+         */
+        std::uint32_t add(const LineView& line);
+        /**
+         * @brief Get the ID of the line with the known hash,
+         * adding the line to the table if it is not there yet
+         *
+         * @param line Line
+         * @param h Hash of the line
+         * @return ID of the line
+         */
+        std::uint32_t add(const LineView& line, std::uint64_t h);
+        /**
+         * @brief Get a new ID for the line that is not shared
+         * with any other line, even with an equal one
+         *
+         * @param line Line
+         * @return ID of the line
+         */
+        std::uint32_t addDistinct(const LineView& line);
+        /**
+         * @brief Get IDs for the range of lines
+         *
+         * @param src Lines
+         * @param first Index of the first line
+         * @param last Index after the last line
+         * @param ids Vector that receives IDs at the same indices as lines
+         */
+        void add(const std::vector<LineView>& src,
+                 std::size_t first, std::size_t last,
+                 std::vector<std::uint32_t>& ids);
+        /**
+         * @brief Get IDs for the range of lines with known hashes
+         *
+         * @param src Lines
+         * @param srcHashes Hashes of lines
+         * @param first Index of the first line
+         * @param last Index after the last line
+         * @param ids Vector that receives IDs at the same indices as lines
+         */
+        void add(const std::vector<LineView>& src,
+                 const std::vector<std::uint64_t>& srcHashes,
+                 std::size_t first, std::size_t last,
+                 std::vector<std::uint32_t>& ids);
+        /**
+         * @brief Get the number of unique lines in the table
+         *
+         * @return Number of unique lines
+         */
+        std::uint32_t size(void) const;
+        /**
+         * @brief Get the line with the specified ID
+         *
+         * @param id ID of the line
+         * @return Line
+         */
+        const LineView& getLine(std::uint32_t id) const;
+};
+
+#endif // LINE_TABLE_H
\ No newline at end of file
@@ -0,0 +1,109 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "line_view.h"
+
+#include <cstring>
+
+/**
+ * @brief Initialize an empty line
+ *
+ */
+LineView::LineView(void) :
+    data(nullptr),  // Empty line does not refer to any memory
+    length(0) { }   // Length of the line
+
+/**
+ * @brief Initialize the line
+ *
+ * @param data Pointer to the first character of the line
+ * @param length Length of the line
+ */
+LineView::LineView(const char* data, std::size_t length) :
+    data(data),         // Pointer to the first character of the line
+    length(length) { }  // Length of the line without the line terminator
+
+/**
+ * @brief Get the pointer to the first character of the line
+ *
+ * @return Pointer to the first character of the line
+ */
+const char* LineView::getData(void) const
+{
+    return data;
+}
+
+/**
+ * @brief Get the length of the line
+ *
+ * @return Length of the line
+ */
+std::size_t LineView::getLength(void) const
+{
+    return length;
+}
+
+/**
+ * @brief Copy the line into a string
+ *
+ * @return Copy of the line
+ */
+std::string LineView::toString(void) const
+{
+    return std::string(data, length);
+}
+
+/**
+ * @brief Compare contents of two lines
+ *
+ * @param other Line to compare with
+ * @return true if lines are equal, false otherwise
+ */
+bool LineView::operator==(const LineView& other) const
+{
+    return length == other.length &&
+           (length == 0 || std::memcmp(data, other.data, length) == 0);
+}
+
+/**
+ * @brief Compare contents of two lines
+ *
+ * @param other Line to compare with
+ * @return true if lines are different, false otherwise
+ */
+bool LineView::operator!=(const LineView& other) const
+{
+    return !(*this == other);
+}
+
+/**
+ * @brief Write the line to the stream
+ *
+ * @param os Output stream
+ * @param line Line
+ * @return Output stream
+ */
+std::ostream& operator<<(std::ostream& os, const LineView& line)
+{
+    return os.write(line.getData(), line.getLength());
+}
\ No newline at end of file
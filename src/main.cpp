@@ -21,8 +21,6 @@
  * SOFTWARE.
  */
 
-#include <exception>
-#include <iostream>
 #include <vector>
 
 #include "app_controller.h"
@@ -39,44 +37,34 @@ int main(int argc, char* argv[])
         Argument("--color",         true,       "false"),
         Argument("-a",              true,       "false"),
         Argument("--force-ansi",    true,       "false"),
+        Argument("-r",              true,       "false"),
+        Argument("--recursive",     true,       "false"),
+        Argument("--batch",         false,      ""),
         Argument("-o",              false,      ""),
         Argument("--out-file",      false,      ""),
         Argument("-n",              false,      "3"),
-        Argument("--lines",         false,      "3")
+        Argument("--lines",         false,      "3"),
+        Argument("--algorithm",     false,      "myers"),
+        Argument("-t",              false,      "1"),
+        Argument("--threads",       false,      "1"),
+        Argument("-d",              true,       "false"),
+        Argument("--minimal",       true,       "false"),
+        Argument("--speed-large-files", true,   "false"),
+        Argument("--bit-parallel-budget", false, "4194304"),
+        Argument("--window",        false,      "0"),
+        Argument("--text",          true,       "false"),
+        Argument("--strip-trailing-cr", true,   "false"),
+        Argument("--read-method",   false,      "pread"),
+        Argument("--cache",         false,      ""),
+        Argument("--cache-size",    false,      "100"),
+        Argument("--incremental",   false,      ""),
+        Argument("--stats",         true,       "false"),
+        Argument("--serve",         false,      ""),
+        Argument("--client",        false,      "")
     };
 
     // Initialize application controller
     AppController controller(argc, argv, args);
 
-    try
-    {
-        // Parse command line arguments
-        if(!controller.parseArguments())
-        {
-            // Close application if help was displayed
-            return 0;
-        }
-    }
-    catch(const std::exception& e)
-    {
-        std::cerr << "Error: " << e.what() << '\n'
-                  << "Use \'cdiff -h\' or  \'cdiff --help\' "
-                  << "for more information\n";
-        return 1;
-    }
-
-    try
-    {
-        // Read contents of the files
-        controller.readFileContents();
-        // Calculate and output the difference between files
-        controller.calculateDiff();
-    }
-    catch(const std::exception& e)
-    {
-        std::cerr << "Error: " << e.what() << '\n';
-        return 1;
-    }
-
-    return 0;
+    return controller.run();
 }
\ No newline at end of file
@@ -0,0 +1,410 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "mapped_file.h"
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include "decompressor.h"
+#include "file_helper.h"
+#include "line_scanner.h"
+#include "line_table.h"
+
+#if !defined(_WIN32) // POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+/**
+ * @brief Map the file into memory and decompress it if needed
+ *
+ * @param fname Filename
+ */
+MappedFile::MappedFile(const std::string& fname) :
+    filename(fname),        // Path to the file
+    lastModified(),         // Taken from the opened file
+    data(nullptr),          // Empty files are not mapped
+    size(0),                // Size of the file in bytes
+    buffer(),               // Used only when the file cannot be mapped
+#if defined(_WIN32)
+    hMapping(NULL),         // Handle of the file mapping
+#endif // _WIN32
+    mapped(false),          // Whether contents are mapped
+    lines(),                // Lines of the file
+    hashes(),               // Hash of each line
+    carriageReturns(false), // Set by the line scanner
+    endingNewLine(true),    // Set by the line scanner
+    split(false),           // Lines are split on demand
+    stripped(false),        // Set when lines are split
+    splitLock()             // Lock for splitting lines
+{
+#if defined(_WIN32) // Windows
+    HANDLE hFile = CreateFileA(fname.c_str(), GENERIC_READ, FILE_SHARE_READ,
+        NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if(hFile == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("could not open " + fname);
+
+    LARGE_INTEGER fileSize;
+
+    if(!GetFileSizeEx(hFile, &fileSize))
+    {
+        CloseHandle(hFile);
+        throw std::runtime_error("could not get the size of " + fname);
+    }
+
+    size = static_cast<std::size_t>(fileSize.QuadPart);
+
+    try
+    {
+        FileHelper::getLastModifiedDate(hFile, lastModified);
+    }
+    catch(...)
+    {
+        CloseHandle(hFile);
+        throw;
+    }
+
+    // Empty files cannot be mapped
+    if(size > 0)
+    {
+        hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+
+        if(hMapping != NULL)
+            data = static_cast<const char*>(MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+
+        if(data == nullptr)
+        {
+            if(hMapping != NULL) CloseHandle(hMapping);
+            CloseHandle(hFile);
+            throw std::runtime_error("could not map " + fname);
+        }
+
+        mapped = true;
+    }
+
+    // The mapping stays valid after the file is closed
+    CloseHandle(hFile);
+#else // POSIX
+    const int fd = open(fname.c_str(), O_RDONLY);
+
+    if(fd == -1)
+        throw std::runtime_error("could not open " + fname);
+
+    struct stat fileStat;
+
+    if(fstat(fd, &fileStat) == -1)
+    {
+        ::close(fd);
+        throw std::runtime_error("could not get the size of " + fname);
+    }
+
+    try
+    {
+        FileHelper::getLastModifiedDate(fileStat, lastModified);
+    }
+    catch(...)
+    {
+        ::close(fd);
+        throw;
+    }
+
+    if(S_ISREG(fileStat.st_mode) && fileStat.st_size > 0)
+    {
+        size = fileStat.st_size;
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if(addr != MAP_FAILED)
+        {
+            data = static_cast<const char*>(addr);
+            mapped = true;
+        }
+    }
+
+    // Pipes and other special files are read into the buffer
+    if(!mapped && !S_ISREG(fileStat.st_mode))
+    {
+        char chunk[65536];
+        ssize_t count;
+
+        while((count = ::read(fd, chunk, sizeof(chunk))) != 0)
+        {
+            if(count == -1)
+            {
+                ::close(fd);
+                throw std::runtime_error("could not read " + fname);
+            }
+
+            buffer.insert(buffer.end(), chunk, chunk + count);
+        }
+
+        size = buffer.size();
+        data = buffer.empty() ? nullptr : buffer.data();
+    }
+    else if(!mapped && size > 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("could not map " + fname);
+    }
+
+    // The mapping stays valid after the file is closed
+    ::close(fd);
+#endif // _WIN32
+
+    try
+    {
+        decompress();
+    }
+    catch(...)
+    {
+        unmap();
+        throw;
+    }
+}
+
+/**
+ * @brief Unmap the file
+ *
+ */
+MappedFile::~MappedFile(void)
+{
+    unmap();
+}
+
+/**
+ * @brief Release the mapping, if any
+ *
+ */
+void MappedFile::unmap(void)
+{
+    if(!mapped) return;
+
+#if defined(_WIN32) // Windows
+    UnmapViewOfFile(data);
+    CloseHandle(hMapping);
+#else // POSIX
+    munmap(const_cast<char*>(data), size);
+#endif // _WIN32
+
+    mapped = false;
+}
+
+/**
+ * @brief Replace compressed contents with decompressed ones
+ *
+ */
+void MappedFile::decompress(void)
+{
+    if(Decompressor::isZstd(data, size))
+        throw std::runtime_error(filename + " is compressed with zstd, which is not supported");
+
+    if(!Decompressor::isGzip(data, size)) return;
+
+    Decompressor decompressor(filename);
+    std::vector<char> contents;
+    // Each part is decompressed into a small buffer that stays in the cache
+    // and appended to contents, so contents are never filled with zeros
+    std::unique_ptr<char[]> chunk(new char[DECOMPRESS_CHUNK_SIZE]);
+    std::size_t part;
+
+    decompressor.setInput(data, size);
+
+    // The trailer holds the exact size of most files,
+    // so contents are usually allocated only once
+    contents.reserve(Decompressor::getSizeHint(data, size));
+
+    do
+    {
+        part = decompressor.decompress(chunk.get(), DECOMPRESS_CHUNK_SIZE);
+        contents.insert(contents.end(), chunk.get(), chunk.get() + part);
+    }
+    while(part == DECOMPRESS_CHUNK_SIZE);
+
+    if(!decompressor.isFinished())
+        throw std::runtime_error("unexpected end of compressed file " + filename);
+
+    // Compressed contents are not needed anymore
+    unmap();
+    buffer.swap(contents);
+    size = buffer.size();
+    data = buffer.empty() ? nullptr : buffer.data();
+}
+
+/**
+ * @brief Split contents into lines and calculate their hashes.
+ * Lines are split again only if "\r" is handled differently.
+ * Safe to call from several threads at once
+ *
+ * @param stripCarriageReturns Whether to remove "\r"
+ * from lines that end with "\r\n"
+ */
+void MappedFile::splitLines(bool stripCarriageReturns)
+{
+    std::lock_guard<std::mutex> guard(splitLock);
+
+    if(split && stripped == stripCarriageReturns) return;
+
+    LineScanner scanner(stripCarriageReturns);
+    scanner.scan(data, size, lines);
+    carriageReturns = scanner.hasCarriageReturns();
+    endingNewLine = scanner.hasEndingNewLine();
+    stripped = stripCarriageReturns;
+
+    // Hashes are calculated here, so that they are ready
+    // when files are split in parallel
+    hashes.resize(lines.size());
+
+    for(std::size_t i = 0; i < lines.size(); i++)
+        hashes[i] = LineTable::hash(lines[i]);
+
+    split = true;
+}
+
+/**
+ * @brief Exchange vectors of lines and hashes with the given ones, so that
+ * their memory is reused. Called before lines are split to take the memory
+ * of a previous file and after the comparison to give it back. Lines
+ * have to be split again afterwards
+ *
+ * @param otherLines Vector of lines
+ * @param otherHashes Vector of hashes
+ */
+void MappedFile::swapLines(std::vector<LineView>& otherLines,
+                           std::vector<std::uint64_t>& otherHashes)
+{
+    lines.swap(otherLines);
+    hashes.swap(otherHashes);
+    split = false;
+}
+
+/**
+ * @brief Check if contents of both files are the same
+ *
+ * @param other Other file
+ * @return true if files are identical, false otherwise
+ */
+bool MappedFile::hasSameContents(const MappedFile& other) const
+{
+    // memcmp of the C library compares whole vector registers at once
+    return size == other.size &&
+           (size == 0 || std::memcmp(data, other.data, size) == 0);
+}
+
+/**
+ * @brief Check if the file looks binary, i.e. the beginning
+ * of the file contains a null byte
+ *
+ * @return true if the file is binary, false otherwise
+ */
+bool MappedFile::isBinary(void) const
+{
+    const std::size_t checked = (size < BINARY_CHECK_SIZE) ? size : BINARY_CHECK_SIZE;
+
+    return checked > 0 && std::memchr(data, '\0', checked) != nullptr;
+}
+
+/**
+ * @brief Get the path to the file
+ *
+ * @return Path to the file
+ */
+const std::string& MappedFile::getFilename(void) const
+{
+    return filename;
+}
+
+/**
+ * @brief Get the last modification date of the file
+ *
+ * @return Last modification date of the file
+ */
+DateTime MappedFile::getLastModified(void) const
+{
+    return lastModified;
+}
+
+/**
+ * @brief Get contents of the file
+ *
+ * @return Pointer to the first byte of the file
+ */
+const char* MappedFile::getData(void) const
+{
+    return data;
+}
+
+/**
+ * @brief Get the size of the file
+ *
+ * @return Size of the file in bytes
+ */
+std::size_t MappedFile::getSize(void) const
+{
+    return size;
+}
+
+/**
+ * @brief Get lines of the file
+ *
+ * @return Vector with lines from file
+ */
+const std::vector<LineView>& MappedFile::getLines(void) const
+{
+    return lines;
+}
+
+/**
+ * @brief Get hashes of lines, calculated the same way as in LineTable
+ *
+ * @return Vector with the hash of each line
+ */
+const std::vector<std::uint64_t>& MappedFile::getHashes(void) const
+{
+    return hashes;
+}
+
+/**
+ * @brief Check if any line of the file ends with "\r\n".
+ * Lines must be split first
+ *
+ * @return true if any line ends with "\r\n", false otherwise
+ */
+bool MappedFile::hasCarriageReturns(void) const
+{
+    return carriageReturns;
+}
+
+/**
+ * @brief Check if the file ends with a new line.
+ * Empty files are considered to end with a new line
+ *
+ * @return true if the file ends with a new line, false otherwise
+ */
+bool MappedFile::hasEndingNewLine(void) const
+{
+    return endingNewLine;
+}
\ No newline at end of file
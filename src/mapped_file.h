@@ -0,0 +1,254 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "date_time.h"
+#include "line_view.h"
+
+// Windows-specific
+#if defined(_WIN32)
+#include <windows.h>
+#endif // _WIN32
+
+/**
+ * @brief Class that maps the whole file into memory for reading.
+ * Lines of the file refer directly to the mapping, so the mapping
+ * must outlive them. The file is opened and queried only once,
+ * all other information is derived from its contents.
+ * Compressed files are detected by their magic bytes
+ * and decompressed into memory. Lines are split only on demand,
+ * so files that need no comparison of lines are not scanned
+ *
+ */
+class MappedFile
+{
+    private:
+        /**
+         * @brief Number of bytes at the beginning of the file
+         * that are checked for null bytes
+         *
+         */
+        static const std::size_t BINARY_CHECK_SIZE = 65536;
+        /**
+         * @brief Number of bytes decompressed at once
+         *
+         */
+        static const std::size_t DECOMPRESS_CHUNK_SIZE = 262144;
+        /**
+         * @brief Path to the file
+         *
+         */
+        std::string filename;
+        /**
+         * @brief Last modification date of the file
+         *
+         */
+        DateTime lastModified;
+        /**
+         * @brief Contents of the file
+         *
+         */
+        const char* data;
+        /**
+         * @brief Size of the file in bytes
+         *
+         */
+        std::size_t size;
+        /**
+         * @brief Contents of files that cannot be mapped, e.g. pipes
+         *
+         */
+        std::vector<char> buffer;
+#if defined(_WIN32) // Windows
+        /**
+         * @brief Handle of the file mapping
+         *
+         */
+        HANDLE hMapping;
+#endif // _WIN32
+        /**
+         * @brief Whether contents are mapped rather than buffered
+         *
+         */
+        bool mapped;
+        /**
+         * @brief Lines of the file
+         *
+         */
+        std::vector<LineView> lines;
+        /**
+         * @brief Hash of each line
+         *
+         */
+        std::vector<std::uint64_t> hashes;
+        /**
+         * @brief Whether any line ends with "\r\n"
+         *
+         */
+        bool carriageReturns;
+        /**
+         * @brief Whether the file ends with a new line
+         *
+         */
+        bool endingNewLine;
+        /**
+         * @brief Whether lines are split
+         *
+         */
+        bool split;
+        /**
+         * @brief Whether "\r" was removed from lines when they were split
+         *
+         */
+        bool stripped;
+        /**
+         * @brief Lock for splitting lines. The same file can be both
+         * inputs, and each input is split on its own thread
+         *
+         */
+        std::mutex splitLock;
+        /**
+         * @brief Release the mapping, if any
+         *
+         */
+        void unmap(void);
+        /**
+         * @brief Replace compressed contents with decompressed ones
+         *
+         */
+        void decompress(void);
+
+    public:
+        /**
+         * @brief Map the file into memory and decompress it if needed
+         *
+         * @param fname Filename
+         */
+        explicit MappedFile(const std::string& fname);
+        /**
+         * @brief Unmap the file
+         *
+         */
+        ~MappedFile(void);
+        /**
+         * @brief Mapping is owned by a single object, so it cannot be copied
+         *
+         */
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        /**
+         * @brief Split contents into lines and calculate their hashes.
+         * Lines are split again only if "\r" is handled differently.
+         * Safe to call from several threads at once
+         *
+         * @param stripCarriageReturns Whether to remove "\r"
+         * from lines that end with "\r\n"
+         */
+        void splitLines(bool stripCarriageReturns);
+        /**
+         * @brief Exchange vectors of lines and hashes with the given ones, so that
+         * their memory is reused. Called before lines are split to take the memory
+         * of a previous file and after the comparison to give it back. Lines
+         * have to be split again afterwards
+         *
+         * @param otherLines Vector of lines
+         * @param otherHashes Vector of hashes
+         */
+        void swapLines(std::vector<LineView>& otherLines,
+                       std::vector<std::uint64_t>& otherHashes);
+        /**
+         * @brief Check if contents of both files are the same
+         *
+         * @param other Other file
+         * @return true if files are identical, false otherwise
+         */
+        bool hasSameContents(const MappedFile& other) const;
+        /**
+         * @brief Check if the file looks binary, i.e. the beginning
+         * of the file contains a null byte
+         *
+         * @return true if the file is binary, false otherwise
+         */
+        bool isBinary(void) const;
+        /**
+         * @brief Get the path to the file
+         *
+         * @return Path to the file
+         */
+        const std::string& getFilename(void) const;
+        /**
+         * @brief Get the last modification date of the file
+         *
+         * @return Last modification date of the file
+         */
+        DateTime getLastModified(void) const;
+        /**
+         * @brief Get contents of the file
+         *
+         * @return Pointer to the first byte of the file
+         */
+        const char* getData(void) const;
+        /**
+         * @brief Get the size of the file
+         *
+         * @return Size of the file in bytes
+         */
+        std::size_t getSize(void) const;
+        /**
+         * @brief Get lines of the file. Lines must be split first
+         *
+         * @return Vector with lines from file
+         */
+        const std::vector<LineView>& getLines(void) const;
+        /**
+         * @brief Get hashes of lines, calculated the same way as in LineTable.
+         * Lines must be split first
+         *
+         * @return Vector with the hash of each line
+         */
+        const std::vector<std::uint64_t>& getHashes(void) const;
+        /**
+         * @brief Check if any line of the file ends with "\r\n".
+         * Lines must be split first
+         *
+         * @return true if any line ends with "\r\n", false otherwise
+         */
+        bool hasCarriageReturns(void) const;
+        /**
+         * @brief Check if the file ends with a new line.
+         * Empty files are considered to end with a new line
+         *
+         * @return true if the file ends with a new line, false otherwise
+         */
+        bool hasEndingNewLine(void) const;
+};
+
+#endif // MAPPED_FILE_H
\ No newline at end of file
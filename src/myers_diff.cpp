@@ -0,0 +1,378 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "myers_diff.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <thread>
+
+/**
+ * @brief Initialize parameters with specified values
+ *
+ * @param original IDs of lines from the original file
+ * @param modified IDs of lines from the modified file
+ */
+MyersDiff::MyersDiff(const std::vector<std::uint32_t>& original,
+                     const std::vector<std::uint32_t>& modified) :
+                     MyersDiff(original, modified, nullptr) { }
+
+/**
+ * @brief Initialize parameters with specified values
+ *
+ * @param original IDs of lines from the original file
+ * @param modified IDs of lines from the modified file
+ * @param pool Pool for solving subproblems in parallel
+ */
+MyersDiff::MyersDiff(const std::vector<std::uint32_t>& original,
+                     const std::vector<std::uint32_t>& modified,
+                     ThreadPool* pool) :
+                     MIN_TASK_SIZE(4096),
+                     original(original),
+                     modified(modified),
+                     pool(pool),
+                     costLimit(INT_MAX),
+                     forward(pool ? pool->getThreadCount() : 1),
+                     backward(pool ? pool->getThreadCount() : 1) { }
+
+/**
+ * @brief Find the middle snake of the edit graph and return
+ * the point where the problem can be split in two
+ *
+ * @param aLo Start of the range in the original file
+ * @param aHi End of the range in the original file
+ * @param bLo Start of the range in the modified file
+ * @param bHi End of the range in the modified file
+ * @param x Split point in the original file
+ * @param y Split point in the modified file
+ * @param forward Furthest-reaching points of the forward search
+ * @param backward Furthest-reaching points of the backward search
+ * @return true if the split point was found, false if ranges
+ * have nothing in common
+ */
+bool MyersDiff::findMiddleSnake(int aLo, int aHi, int bLo, int bHi,
+                                int& x, int& y,
+                                std::vector<int>& forward,
+                                std::vector<int>& backward) const
+{
+    const int n = aHi - aLo;
+    const int m = bHi - bLo;
+    // Maximum number of steps needed for both searches to meet
+    const int maxD = (n + m + 1) / 2;
+    const int offset = maxD;
+    const int length = 2 * maxD + 2;
+    const int delta = n - m;
+    // If the difference is odd, paths overlap during the forward search
+    const bool front = (delta % 2 != 0);
+
+    // Only the part of the vectors used by this range is reset,
+    // so the memory is allocated once for each thread
+    if(forward.size() < static_cast<std::size_t>(length))
+    {
+        forward.resize(length);
+        backward.resize(length);
+    }
+
+    std::fill(forward.begin(), forward.begin() + length, -1);
+    std::fill(backward.begin(), backward.begin() + length, -1);
+    forward[offset + 1] = 0;
+    backward[offset + 1] = 0;
+
+    // Diagonals that went outside the edit graph are skipped
+    int kForwardStart = 0, kForwardEnd = 0;
+    int kBackwardStart = 0, kBackwardEnd = 0;
+    int x1, y1, x2, y2, kOffset;
+
+    for(int d = 0; d < maxD; d++) // Possible differences
+    {
+        // Walk the forward path one step
+        for(int k = -d + kForwardStart; k <= d - kForwardEnd; k += 2)
+        {
+            kOffset = offset + k;
+
+            if(k == -d || (k != d && forward[kOffset - 1] < forward[kOffset + 1]))
+                x1 = forward[kOffset + 1]; // Move down (insertion)
+            else
+                x1 = forward[kOffset - 1] + 1; // Move right (removal)
+
+            y1 = x1 - k;
+
+            // Follow the diagonal while lines are unchanged
+            while(x1 < n && y1 < m && original[aLo + x1] == modified[bLo + y1])
+            {
+                x1++;
+                y1++;
+            }
+
+            forward[kOffset] = x1;
+
+            if(x1 > n) // Ran off the right of the graph
+            {
+                kForwardEnd += 2;
+            }
+            else if(y1 > m) // Ran off the bottom of the graph
+            {
+                kForwardStart += 2;
+            }
+            else if(front)
+            {
+                kOffset = offset + delta - k;
+
+                // Check if the path overlaps the backward path
+                if(kOffset >= 0 && kOffset < length && backward[kOffset] != -1 &&
+                   x1 >= n - backward[kOffset])
+                {
+                    x = aLo + x1;
+                    y = bLo + y1;
+                    return true;
+                }
+            }
+        }
+
+        // Walk the backward path one step
+        for(int k = -d + kBackwardStart; k <= d - kBackwardEnd; k += 2)
+        {
+            kOffset = offset + k;
+
+            if(k == -d || (k != d && backward[kOffset - 1] < backward[kOffset + 1]))
+                x2 = backward[kOffset + 1];
+            else
+                x2 = backward[kOffset - 1] + 1;
+
+            y2 = x2 - k;
+
+            // Follow the diagonal from the end of both ranges
+            while(x2 < n && y2 < m &&
+                  original[aHi - x2 - 1] == modified[bHi - y2 - 1])
+            {
+                x2++;
+                y2++;
+            }
+
+            backward[kOffset] = x2;
+
+            if(x2 > n) // Ran off the left of the graph
+            {
+                kBackwardEnd += 2;
+            }
+            else if(y2 > m) // Ran off the top of the graph
+            {
+                kBackwardStart += 2;
+            }
+            else if(!front)
+            {
+                kOffset = offset + delta - k;
+
+                // Check if the path overlaps the forward path
+                if(kOffset >= 0 && kOffset < length && forward[kOffset] != -1)
+                {
+                    x1 = forward[kOffset];
+                    y1 = x1 - (kOffset - offset);
+
+                    if(x1 >= n - x2)
+                    {
+                        x = aLo + x1;
+                        y = bLo + y1;
+                        return true;
+                    }
+                }
+            }
+        }
+
+        // The search is too expensive. Give up on the shortest edit
+        // script and split on the point that got the furthest so far
+        if(d >= costLimit)
+        {
+            // Progress made from the start and from the end
+            int bestForward = -1, bestBackward = -1;
+            int forwardX = 0, backwardX = 0;
+
+            for(int k = -d + kForwardStart; k <= d - kForwardEnd; k += 2)
+            {
+                x1 = std::min(forward[offset + k], n);
+                y1 = x1 - k;
+
+                // Move the point back inside the edit graph
+                if(y1 > m)
+                {
+                    x1 = m + k;
+                    y1 = m;
+                }
+
+                if(y1 >= 0 && x1 + y1 > bestForward)
+                {
+                    bestForward = x1 + y1;
+                    forwardX = x1;
+                }
+            }
+
+            for(int k = -d + kBackwardStart; k <= d - kBackwardEnd; k += 2)
+            {
+                x2 = std::min(backward[offset + k], n);
+                y2 = x2 - k;
+
+                // Move the point back inside the edit graph
+                if(y2 > m)
+                {
+                    x2 = m + k;
+                    y2 = m;
+                }
+
+                if(y2 >= 0 && x2 + y2 > bestBackward)
+                {
+                    bestBackward = x2 + y2;
+                    backwardX = x2;
+                }
+            }
+
+            if(bestForward >= bestBackward)
+            {
+                x = aLo + forwardX;
+                y = bLo + bestForward - forwardX;
+            }
+            else
+            {
+                x = aHi - backwardX;
+                y = bHi - (bestBackward - backwardX);
+            }
+
+            // Both parts must be smaller than the whole range
+            return bestForward + bestBackward > -2 &&
+                   (x - aLo) + (y - bLo) > 0 && (aHi - x) + (bHi - y) > 0;
+        }
+    }
+
+    // Ranges have no lines in common
+    return false;
+}
+
+/**
+ * @brief Recursively compare ranges of both files and mark
+ * lines that are not part of the longest common subsequence.
+ * Halves of large ranges are solved in parallel if there is a pool
+ *
+ * @param aLo Start of the range in the original file
+ * @param aHi End of the range in the original file
+ * @param bLo Start of the range in the modified file
+ * @param bHi End of the range in the modified file
+ * @param removed Flags of removed lines in the original file
+ * @param inserted Flags of inserted lines in the modified file
+ */
+void MyersDiff::compare(int aLo, int aHi, int bLo, int bHi,
+                        std::vector<char>& removed,
+                        std::vector<char>& inserted)
+{
+    // Buffers of the current thread
+    const std::size_t slot = pool ? pool->getCurrentIndex() : 0;
+    int x, y;
+
+    // Skip unchanged lines at the start of both ranges
+    while(aLo < aHi && bLo < bHi && original[aLo] == modified[bLo])
+    {
+        aLo++;
+        bLo++;
+    }
+
+    // Skip unchanged lines at the end of both ranges
+    while(aLo < aHi && bLo < bHi && original[aHi - 1] == modified[bHi - 1])
+    {
+        aHi--;
+        bHi--;
+    }
+
+    if(aLo == aHi) // All remaining lines were inserted
+    {
+        std::fill(inserted.begin() + bLo, inserted.begin() + bHi, 1);
+    }
+    else if(bLo == bHi) // All remaining lines were removed
+    {
+        std::fill(removed.begin() + aLo, removed.begin() + aHi, 1);
+    }
+    else if(findMiddleSnake(aLo, aHi, bLo, bHi, x, y,
+                            forward[slot], backward[slot]))
+    {
+        if(pool != nullptr && (x - aLo) + (y - bLo) >= MIN_TASK_SIZE)
+        {
+            // Halves change different flags, so the first half can be
+            // solved by another thread without locking
+            std::atomic<bool> done(false);
+
+            pool->submit([&]()
+            {
+                compare(aLo, x, bLo, y, removed, inserted);
+                done = true;
+            });
+
+            compare(x, aHi, y, bHi, removed, inserted);
+
+            // Help with other tasks until the first half is solved
+            while(!done)
+            {
+                if(!pool->runPendingTask())
+                    std::this_thread::yield();
+            }
+        }
+        else
+        {
+            // Solve both halves independently
+            compare(aLo, x, bLo, y, removed, inserted);
+            compare(x, aHi, y, bHi, removed, inserted);
+        }
+    }
+    else // Ranges have nothing in common
+    {
+        std::fill(removed.begin() + aLo, removed.begin() + aHi, 1);
+        std::fill(inserted.begin() + bLo, inserted.begin() + bHi, 1);
+    }
+}
+
+/**
+ * @brief Calculate the difference between ranges of two sequences.
+ * Only flags of lines within the ranges are changed
+ *
+ * @param aLo Start of the range in the original file
+ * @param aHi End of the range in the original file
+ * @param bLo Start of the range in the modified file
+ * @param bHi End of the range in the modified file
+ * @param removed Flags of removed lines in the original file
+ * @param inserted Flags of inserted lines in the modified file
+ */
+void MyersDiff::calculate(int aLo, int aHi, int bLo, int bHi,
+                          std::vector<char>& removed,
+                          std::vector<char>& inserted)
+{
+    compare(aLo, aHi, bLo, bHi, removed, inserted);
+}
+
+/**
+ * @brief Set the number of steps of the middle snake search after which
+ * the range is split on the furthest point found so far. The result is
+ * still a valid edit script, but it may be longer than the shortest one
+ *
+ * @param costLimit Maximum number of steps, INT_MAX for the exact search
+ */
+void MyersDiff::setCostLimit(int costLimit)
+{
+    this->costLimit = costLimit;
+}
\ No newline at end of file
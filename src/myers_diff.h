@@ -0,0 +1,159 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef MYERS_DIFF_H
+#define MYERS_DIFF_H
+
+#include <cstdint>
+#include <vector>
+
+#include "thread_pool.h"
+
+/**
+ * @brief Class for calculating the difference between two sequences
+ * in linear space. Based on the divide-and-conquer (middle snake)
+ * variant from 'An O(ND) Difference Algorithm' by Eugene W. Myers
+ * http://www.xmailserver.org/diff2.pdf
+ *
+ */
+class MyersDiff
+{
+    private:
+        /**
+         * @brief Subproblems with fewer lines are not
+         * worth scheduling on another thread
+         *
+         */
+        const int MIN_TASK_SIZE;
+        /**
+         * @brief IDs of lines from the original file
+         *
+         */
+        const std::vector<std::uint32_t>& original;
+        /**
+         * @brief IDs of lines from the modified file
+         *
+         */
+        const std::vector<std::uint32_t>& modified;
+        /**
+         * @brief Pool for solving subproblems in parallel or nullptr
+         *
+         */
+        ThreadPool* pool;
+        /**
+         * @brief Number of steps of the middle snake search
+         * after which the search gives up on the shortest edit script
+         *
+         */
+        int costLimit;
+        /**
+         * @brief Furthest-reaching points of the forward search
+         * for each thread
+         *
+         */
+        std::vector<std::vector<int>> forward;
+        /**
+         * @brief Furthest-reaching points of the backward search
+         * for each thread
+         *
+         */
+        std::vector<std::vector<int>> backward;
+        /**
+         * @brief Find the middle snake of the edit graph and return
+         * the point where the problem can be split in two
+         *
+         * @param aLo Start of the range in the original file
+         * @param aHi End of the range in the original file
+         * @param bLo Start of the range in the modified file
+         * @param bHi End of the range in the modified file
+         * @param x Split point in the original file
+         * @param y Split point in the modified file
+         * @param forward Furthest-reaching points of the forward search
+         * @param backward Furthest-reaching points of the backward search
+         * @return true if the split point was found, false if ranges
+         * have nothing in common
+         */
+        bool findMiddleSnake(int aLo, int aHi, int bLo, int bHi,
+                             int& x, int& y,
+                             std::vector<int>& forward,
+                             std::vector<int>& backward) const;
+        /**
+         * @brief Recursively compare ranges of both files and mark
+         * lines that are not part of the longest common subsequence.
+         * Halves of large ranges are solved in parallel if there is a pool
+         *
+         * @param aLo Start of the range in the original file
+         * @param aHi End of the range in the original file
+         * @param bLo Start of the range in the modified file
+         * @param bHi End of the range in the modified file
+         * @param removed Flags of removed lines in the original file
+         * @param inserted Flags of inserted lines in the modified file
+         */
+        void compare(int aLo, int aHi, int bLo, int bHi,
+                     std::vector<char>& removed,
+                     std::vector<char>& inserted);
+
+    public:
+        /**
+         * @brief Initialize parameters with specified values
+         *
+         * @param original IDs of lines from the original file
+         * @param modified IDs of lines from the modified file
+         */
+        MyersDiff(const std::vector<std::uint32_t>& original,
+                  const std::vector<std::uint32_t>& modified);
+        /**
+         * @brief Initialize parameters with specified values
+         *
+         * @param original IDs of lines from the original file
+         * @param modified IDs of lines from the modified file
+         * @param pool Pool for solving subproblems in parallel
+         */
+        MyersDiff(const std::vector<std::uint32_t>& original,
+                  const std::vector<std::uint32_t>& modified,
+                  ThreadPool* pool);
+        /**
+         * @brief Calculate the difference between ranges of two sequences.
+         * Only flags of lines within the ranges are changed
+         *
+         * @param aLo Start of the range in the original file
+         * @param aHi End of the range in the original file
+         * @param bLo Start of the range in the modified file
+         * @param bHi End of the range in the modified file
+         * @param removed Flags of removed lines in the original file
+         * @param inserted Flags of inserted lines in the modified file
+         */
+        void calculate(int aLo, int aHi, int bLo, int bHi,
+                       std::vector<char>& removed,
+                       std::vector<char>& inserted);
+        /**
+         * @brief Set the number of steps of the middle snake search after which
+         * the range is split on the furthest point found so far. The result is
+         * still a valid edit script, but it may be longer than the shortest one
+         *
+         * @param costLimit Maximum number of steps, INT_MAX for the exact search
+         */
+        void setCostLimit(int costLimit);
+};
+
+#endif // MYERS_DIFF_H
\ No newline at end of file
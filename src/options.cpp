@@ -32,7 +32,24 @@ Options::Options(void) :
     forceAnsiCodes(false),  // Whether to use ANSI escape codes on Windows
     outputToFile(false),    // Whether to output to file instead of a console
     contextLines(3),        // Number of context lines
-    outputFilePath() { }    // Path to the output file
+    outputFilePath(),       // Path to the output file
+    algorithm(Algorithm::Myers), // Algorithm for calculating the difference
+    threadCount(1),         // Number of threads for calculating the difference
+    minimal(false),         // Whether to always search for the shortest script
+    speedLargeFiles(false), // Whether to give up earlier for large files
+    bitParallelBudget(4194304), // Maximum size of the bit-parallel table
+    windowSize(0),          // Lines in each window of streaming mode
+    treatAsText(false),     // Whether to compare binary files as text
+    stripTrailingCr(false), // Lines are compared with "\r"
+    readMethod(ReadMethod::Pread), // Method of reading files in streaming mode
+    recursive(false),       // Whether to compare directories
+    batchManifest(),        // Path to the manifest of batch mode
+    serveSocket(),          // Socket of server mode
+    clientSocket(),         // Socket of client mode
+    cacheDirectory(),       // Edit scripts are not cached
+    cacheSize(100),         // Maximum size of the cache in megabytes
+    incrementalState(),     // Previous runs are not used
+    stats(false) { }        // Statistics are not printed
 
 /**
  * @brief Check whether colors are used when printing to console
@@ -132,4 +149,363 @@ std::string Options::getOutputFilePath(void) const
 void Options::setOutputFilePath(const std::string& outputFilePath)
 {
     this->outputFilePath = outputFilePath;
+}
+
+/**
+ * @brief Get the algorithm for calculating the difference
+ *
+ * @return Algorithm for calculating the difference
+ */
+Algorithm Options::getAlgorithm(void) const
+{
+    return this->algorithm;
+}
+
+/**
+ * @brief Set the algorithm for calculating the difference
+ *
+ * @param algorithm Algorithm for calculating the difference
+ */
+void Options::setAlgorithm(Algorithm algorithm)
+{
+    this->algorithm = algorithm;
+}
+
+/**
+ * @brief Get the number of threads for calculating the difference
+ *
+ * @return Number of threads
+ */
+unsigned int Options::getThreadCount(void) const
+{
+    return this->threadCount;
+}
+
+/**
+ * @brief Set the number of threads for calculating the difference
+ *
+ * @param threadCount Number of threads
+ */
+void Options::setThreadCount(unsigned int threadCount)
+{
+    this->threadCount = threadCount;
+}
+
+/**
+ * @brief Check whether the shortest edit script is always searched for
+ *
+ * @return true if the shortest edit script is always searched for,
+ * false otherwise
+ */
+bool Options::getMinimal(void) const
+{
+    return this->minimal;
+}
+
+/**
+ * @brief Specify whether the shortest edit script is always searched for
+ *
+ * @param minimal Whether the shortest edit script is always searched for
+ */
+void Options::setMinimal(bool minimal)
+{
+    this->minimal = minimal;
+}
+
+/**
+ * @brief Check whether the search gives up earlier for large files
+ *
+ * @return true if the search gives up earlier for large files,
+ * false otherwise
+ */
+bool Options::getSpeedLargeFiles(void) const
+{
+    return this->speedLargeFiles;
+}
+
+/**
+ * @brief Specify whether the search gives up earlier for large files
+ *
+ * @param speedLargeFiles Whether the search gives up earlier for large files
+ */
+void Options::setSpeedLargeFiles(bool speedLargeFiles)
+{
+    this->speedLargeFiles = speedLargeFiles;
+}
+
+/**
+ * @brief Get the maximum size of the table for the bit-parallel
+ * algorithm in 64-bit words
+ *
+ * @return Maximum size of the table
+ */
+unsigned int Options::getBitParallelBudget(void) const
+{
+    return this->bitParallelBudget;
+}
+
+/**
+ * @brief Set the maximum size of the table for the bit-parallel
+ * algorithm in 64-bit words
+ *
+ * @param bitParallelBudget Maximum size of the table
+ */
+void Options::setBitParallelBudget(unsigned int bitParallelBudget)
+{
+    this->bitParallelBudget = bitParallelBudget;
+}
+
+/**
+ * @brief Get the number of lines in each window of streaming mode
+ *
+ * @return Number of lines in each window, 0 if files are loaded whole
+ */
+unsigned int Options::getWindowSize(void) const
+{
+    return this->windowSize;
+}
+
+/**
+ * @brief Set the number of lines in each window of streaming mode
+ *
+ * @param windowSize Number of lines in each window, 0 to load whole files
+ */
+void Options::setWindowSize(unsigned int windowSize)
+{
+    this->windowSize = windowSize;
+}
+
+/**
+ * @brief Check whether to compare binary files as text
+ *
+ * @return true if binary files are compared as text, false otherwise
+ */
+bool Options::getTreatAsText(void) const
+{
+    return this->treatAsText;
+}
+
+/**
+ * @brief Set whether to compare binary files as text
+ *
+ * @param treatAsText Whether to compare binary files as text
+ */
+void Options::setTreatAsText(bool treatAsText)
+{
+    this->treatAsText = treatAsText;
+}
+
+/**
+ * @brief Check whether to remove "\r" from lines that end with "\r\n"
+ *
+ * @return true if "\r" is removed, false otherwise
+ */
+bool Options::getStripTrailingCr(void) const
+{
+    return this->stripTrailingCr;
+}
+
+/**
+ * @brief Set whether to remove "\r" from lines that end with "\r\n"
+ *
+ * @param stripTrailingCr Whether to remove "\r"
+ */
+void Options::setStripTrailingCr(bool stripTrailingCr)
+{
+    this->stripTrailingCr = stripTrailingCr;
+}
+
+/**
+ * @brief Get the method of reading files in streaming mode
+ *
+ * @return Method of reading files in streaming mode
+ */
+ReadMethod Options::getReadMethod(void) const
+{
+    return this->readMethod;
+}
+
+/**
+ * @brief Set the method of reading files in streaming mode
+ *
+ * @param readMethod Method of reading files in streaming mode
+ */
+void Options::setReadMethod(ReadMethod readMethod)
+{
+    this->readMethod = readMethod;
+}
+
+/**
+ * @brief Check whether to compare directories recursively
+ *
+ * @return true if directories are compared recursively, false otherwise
+ */
+bool Options::getRecursive(void) const
+{
+    return this->recursive;
+}
+
+/**
+ * @brief Set whether to compare directories recursively
+ *
+ * @param recursive Whether to compare directories recursively
+ */
+void Options::setRecursive(bool recursive)
+{
+    this->recursive = recursive;
+}
+
+/**
+ * @brief Get the path to the manifest with pairs of files
+ *
+ * @return Path to the manifest, empty if batch mode is off
+ */
+std::string Options::getBatchManifest(void) const
+{
+    return this->batchManifest;
+}
+
+/**
+ * @brief Set the path to the manifest with pairs of files
+ *
+ * @param batchManifest Path to the manifest, "-" for the standard input
+ */
+void Options::setBatchManifest(const std::string& batchManifest)
+{
+    this->batchManifest = batchManifest;
+}
+
+/**
+ * @brief Get the path to the socket the server listens on
+ *
+ * @return Path to the socket, empty if server mode is off
+ */
+std::string Options::getServeSocket(void) const
+{
+    return this->serveSocket;
+}
+
+/**
+ * @brief Set the path to the socket the server listens on
+ *
+ * @param serveSocket Path to the socket
+ */
+void Options::setServeSocket(const std::string& serveSocket)
+{
+    this->serveSocket = serveSocket;
+}
+
+/**
+ * @brief Get the path to the socket of the server the request is sent to
+ *
+ * @return Path to the socket, empty if client mode is off
+ */
+std::string Options::getClientSocket(void) const
+{
+    return this->clientSocket;
+}
+
+/**
+ * @brief Set the path to the socket of the server the request is sent to
+ *
+ * @param clientSocket Path to the socket
+ */
+void Options::setClientSocket(const std::string& clientSocket)
+{
+    this->clientSocket = clientSocket;
+}
+
+/**
+ * @brief Get the directory of the cache of edit scripts
+ *
+ * @return Path to the directory, empty if edit scripts are not cached
+ */
+std::string Options::getCacheDirectory(void) const
+{
+    return this->cacheDirectory;
+}
+
+/**
+ * @brief Set the directory of the cache of edit scripts
+ *
+ * @param cacheDirectory Path to the directory, empty to disable the cache
+ */
+void Options::setCacheDirectory(const std::string& cacheDirectory)
+{
+    this->cacheDirectory = cacheDirectory;
+}
+
+/**
+ * @brief Get the maximum size of the cache of edit scripts
+ *
+ * @return Maximum size in megabytes
+ */
+unsigned int Options::getCacheSize(void) const
+{
+    return this->cacheSize;
+}
+
+/**
+ * @brief Set the maximum size of the cache of edit scripts
+ *
+ * @param cacheSize Maximum size in megabytes
+ */
+void Options::setCacheSize(unsigned int cacheSize)
+{
+    this->cacheSize = cacheSize;
+}
+
+/**
+ * @brief Get the description of options that change the edit script.
+ * Threads do not change it, the result is the same for any number
+ *
+ * @return Values of options separated by spaces
+ */
+std::string Options::getScriptSignature(void) const
+{
+    return std::to_string(static_cast<int>(algorithm)) + ' ' +
+           std::to_string(minimal) + ' ' +
+           std::to_string(speedLargeFiles) + ' ' +
+           std::to_string(bitParallelBudget) + ' ' +
+           std::to_string(stripTrailingCr);
+}
+
+/**
+ * @brief Get the path to the state of the previous run
+ *
+ * @return Path to the state, empty if incremental mode is off
+ */
+std::string Options::getIncrementalState(void) const
+{
+    return this->incrementalState;
+}
+
+/**
+ * @brief Set the path to the state of the previous run
+ *
+ * @param incrementalState Path to the state, empty to disable incremental mode
+ */
+void Options::setIncrementalState(const std::string& incrementalState)
+{
+    this->incrementalState = incrementalState;
+}
+
+/**
+ * @brief Check whether statistics of the calculation are printed
+ *
+ * @return true if statistics are printed, false otherwise
+ */
+bool Options::getStats(void) const
+{
+    return this->stats;
+}
+
+/**
+ * @brief Set whether statistics of the calculation are printed
+ *
+ * @param stats Whether to print statistics
+ */
+void Options::setStats(bool stats)
+{
+    this->stats = stats;
 }
\ No newline at end of file
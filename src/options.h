@@ -26,6 +26,28 @@
 
 #include <string>
 
+/**
+ * @brief Algorithms for calculating the difference
+ *
+ */
+enum class Algorithm
+{
+    Myers,      // Linear space Myers algorithm (default)
+    Patience,   // Patience algorithm that aligns on unique lines
+    Histogram,  // Histogram algorithm that splits on rare lines
+    Legacy      // Original Myers implementation that keeps history of changes
+};
+
+/**
+ * @brief Methods of reading files in streaming mode
+ *
+ */
+enum class ReadMethod
+{
+    Pread,      // One blocking read at a time (default)
+    IoUring     // Several reads in flight through io_uring, if available
+};
+
 /**
  * @brief Program options
  *
@@ -58,6 +80,95 @@ class Options
          *
          */
         std::string outputFilePath;
+        /**
+         * @brief Algorithm for calculating the difference
+         *
+         */
+        Algorithm algorithm;
+        /**
+         * @brief Number of threads for calculating the difference
+         *
+         */
+        unsigned int threadCount;
+        /**
+         * @brief Whether to always search for the shortest edit script
+         *
+         */
+        bool minimal;
+        /**
+         * @brief Whether to give up on the shortest edit script
+         * earlier for large files
+         *
+         */
+        bool speedLargeFiles;
+        /**
+         * @brief Maximum size of the table for the bit-parallel algorithm
+         * in 64-bit words
+         *
+         */
+        unsigned int bitParallelBudget;
+        /**
+         * @brief Number of lines in each window when files are compared
+         * in streaming mode, 0 to load whole files
+         *
+         */
+        unsigned int windowSize;
+        /**
+         * @brief Whether to compare binary files as text
+         *
+         */
+        bool treatAsText;
+        /**
+         * @brief Whether to remove "\r" from lines that end with "\r\n"
+         *
+         */
+        bool stripTrailingCr;
+        /**
+         * @brief Method of reading files in streaming mode
+         *
+         */
+        ReadMethod readMethod;
+        /**
+         * @brief Whether to compare directories recursively
+         *
+         */
+        bool recursive;
+        /**
+         * @brief Path to the manifest with pairs of files, empty if batch mode is off
+         *
+         */
+        std::string batchManifest;
+        /**
+         * @brief Path to the socket the server listens on, empty if server mode is off
+         *
+         */
+        std::string serveSocket;
+        /**
+         * @brief Path to the socket of the server the request is sent to,
+         * empty if client mode is off
+         *
+         */
+        std::string clientSocket;
+        /**
+         * @brief Directory of the cache of edit scripts, empty if edit scripts are not cached
+         *
+         */
+        std::string cacheDirectory;
+        /**
+         * @brief Maximum size of the cache of edit scripts in megabytes
+         *
+         */
+        unsigned int cacheSize;
+        /**
+         * @brief Path to the state of the previous run, empty if incremental mode is off
+         *
+         */
+        std::string incrementalState;
+        /**
+         * @brief Whether to print statistics of the calculation
+         *
+         */
+        bool stats;
 
     public:
         /**
@@ -125,6 +236,221 @@ class Options
          * @param outputFilePath Path to the output file
          */
         void setOutputFilePath(const std::string& outputFilePath);
+        /**
+         * @brief Get the algorithm for calculating the difference
+         *
+         * @return Algorithm for calculating the difference
+         */
+        Algorithm getAlgorithm(void) const;
+        /**
+         * @brief Set the algorithm for calculating the difference
+         *
+         * @param algorithm Algorithm for calculating the difference
+         */
+        void setAlgorithm(Algorithm algorithm);
+        /**
+         * @brief Get the number of threads for calculating the difference
+         *
+         * @return Number of threads
+         */
+        unsigned int getThreadCount(void) const;
+        /**
+         * @brief Set the number of threads for calculating the difference
+         *
+         * @param threadCount Number of threads
+         */
+        void setThreadCount(unsigned int threadCount);
+        /**
+         * @brief Check whether the shortest edit script is always searched for
+         *
+         * @return true if the shortest edit script is always searched for,
+         * false otherwise
+         */
+        bool getMinimal(void) const;
+        /**
+         * @brief Specify whether the shortest edit script is always searched for
+         *
+         * @param minimal Whether the shortest edit script is always searched for
+         */
+        void setMinimal(bool minimal);
+        /**
+         * @brief Check whether the search gives up earlier for large files
+         *
+         * @return true if the search gives up earlier for large files,
+         * false otherwise
+         */
+        bool getSpeedLargeFiles(void) const;
+        /**
+         * @brief Specify whether the search gives up earlier for large files
+         *
+         * @param speedLargeFiles Whether the search gives up earlier for large files
+         */
+        void setSpeedLargeFiles(bool speedLargeFiles);
+        /**
+         * @brief Get the maximum size of the table for the bit-parallel
+         * algorithm in 64-bit words
+         *
+         * @return Maximum size of the table
+         */
+        unsigned int getBitParallelBudget(void) const;
+        /**
+         * @brief Set the maximum size of the table for the bit-parallel
+         * algorithm in 64-bit words
+         *
+         * @param bitParallelBudget Maximum size of the table
+         */
+        void setBitParallelBudget(unsigned int bitParallelBudget);
+        /**
+         * @brief Get the number of lines in each window of streaming mode
+         *
+         * @return Number of lines in each window, 0 if files are loaded whole
+         */
+        unsigned int getWindowSize(void) const;
+        /**
+         * @brief Set the number of lines in each window of streaming mode
+         *
+         * @param windowSize Number of lines in each window, 0 to load whole files
+         */
+        void setWindowSize(unsigned int windowSize);
+        /**
+         * @brief Check whether to compare binary files as text
+         *
+         * @return true if binary files are compared as text, false otherwise
+         */
+        bool getTreatAsText(void) const;
+        /**
+         * @brief Set whether to compare binary files as text
+         *
+         * @param treatAsText Whether to compare binary files as text
+         */
+        void setTreatAsText(bool treatAsText);
+        /**
+         * @brief Check whether to remove "\r" from lines that end with "\r\n"
+         *
+         * @return true if "\r" is removed, false otherwise
+         */
+        bool getStripTrailingCr(void) const;
+        /**
+         * @brief Set whether to remove "\r" from lines that end with "\r\n"
+         *
+         * @param stripTrailingCr Whether to remove "\r"
+         */
+        void setStripTrailingCr(bool stripTrailingCr);
+        /**
+         * @brief Get the method of reading files in streaming mode
+         *
+         * @return Method of reading files in streaming mode
+         */
+        ReadMethod getReadMethod(void) const;
+        /**
+         * @brief Set the method of reading files in streaming mode
+         *
+         * @param readMethod Method of reading files in streaming mode
+         */
+        void setReadMethod(ReadMethod readMethod);
+        /**
+         * @brief Check whether to compare directories recursively
+         *
+         * @return true if directories are compared recursively, false otherwise
+         */
+        bool getRecursive(void) const;
+        /**
+         * @brief Set whether to compare directories recursively
+         *
+         * @param recursive Whether to compare directories recursively
+         */
+        void setRecursive(bool recursive);
+        /**
+         * @brief Get the path to the manifest with pairs of files
+         *
+         * @return Path to the manifest, empty if batch mode is off
+         */
+        std::string getBatchManifest(void) const;
+        /**
+         * @brief Set the path to the manifest with pairs of files
+         *
+         * @param batchManifest Path to the manifest, "-" for the standard input
+         */
+        void setBatchManifest(const std::string& batchManifest);
+        /**
+         * @brief Get the path to the socket the server listens on
+         *
+         * @return Path to the socket, empty if server mode is off
+         */
+        std::string getServeSocket(void) const;
+        /**
+         * @brief Set the path to the socket the server listens on
+         *
+         * @param serveSocket Path to the socket
+         */
+        void setServeSocket(const std::string& serveSocket);
+        /**
+         * @brief Get the path to the socket of the server the request is sent to
+         *
+         * @return Path to the socket, empty if client mode is off
+         */
+        std::string getClientSocket(void) const;
+        /**
+         * @brief Set the path to the socket of the server the request is sent to
+         *
+         * @param clientSocket Path to the socket
+         */
+        void setClientSocket(const std::string& clientSocket);
+        /**
+         * @brief Get the directory of the cache of edit scripts
+         *
+         * @return Path to the directory, empty if edit scripts are not cached
+         */
+        std::string getCacheDirectory(void) const;
+        /**
+         * @brief Set the directory of the cache of edit scripts
+         *
+         * @param cacheDirectory Path to the directory, empty to disable the cache
+         */
+        void setCacheDirectory(const std::string& cacheDirectory);
+        /**
+         * @brief Get the maximum size of the cache of edit scripts
+         *
+         * @return Maximum size in megabytes
+         */
+        unsigned int getCacheSize(void) const;
+        /**
+         * @brief Set the maximum size of the cache of edit scripts
+         *
+         * @param cacheSize Maximum size in megabytes
+         */
+        void setCacheSize(unsigned int cacheSize);
+        /**
+         * @brief Get the description of options that change the edit script.
+         * Threads do not change it, the result is the same for any number
+         *
+         * @return Values of options separated by spaces
+         */
+        std::string getScriptSignature(void) const;
+        /**
+         * @brief Get the path to the state of the previous run
+         *
+         * @return Path to the state, empty if incremental mode is off
+         */
+        std::string getIncrementalState(void) const;
+        /**
+         * @brief Set the path to the state of the previous run
+         *
+         * @param incrementalState Path to the state, empty to disable incremental mode
+         */
+        void setIncrementalState(const std::string& incrementalState);
+        /**
+         * @brief Check whether statistics of the calculation are printed
+         *
+         * @return true if statistics are printed, false otherwise
+         */
+        bool getStats(void) const;
+        /**
+         * @brief Set whether statistics of the calculation are printed
+         *
+         * @param stats Whether to print statistics
+         */
+        void setStats(bool stats);
 };
 
 #endif // OPTIONS_H
\ No newline at end of file
@@ -0,0 +1,409 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "output_sink.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+
+#include "string_helper.h"
+
+#if defined(_WIN32) // Windows
+#include <fcntl.h>
+#include <io.h>
+#else // POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif // _WIN32
+
+/**
+ * @brief Write to the standard output
+ *
+ */
+OutputSink::OutputSink(void) :
+    fd(1),                      // Standard output
+    ownsFd(false),              // Standard output stays open
+    buffer(BUFFER_SIZE),        // Buffer is allocated once
+    used(0),                    // Buffer is empty
+    compressor(),               // Standard output is not compressed
+    target(nullptr)             // Output goes to the file descriptor
+#if !defined(_WIN32)
+    , pending(0)                // Nothing is covered by slices
+    , slices()                  // Slices to be written
+#endif // _WIN32
+{ }
+
+/**
+ * @brief Create or truncate the file and write to it.
+ * The output is compressed if the file has the ".gz" extension
+ *
+ * @param fname Filename
+ * @param background Whether to compress on a separate thread
+ */
+OutputSink::OutputSink(const std::string& fname, bool background) :
+    fd(-1),                     // Opened below
+    ownsFd(true),               // File is closed by the sink
+    buffer(BUFFER_SIZE),        // Buffer is allocated once
+    used(0),                    // Buffer is empty
+    compressor(),               // Created below for compressed files
+    target(nullptr)             // Output goes to the file descriptor
+#if !defined(_WIN32)
+    , pending(0)                // Nothing is covered by slices
+    , slices()                  // Slices to be written
+#endif // _WIN32
+{
+    const bool gzip = StringHelper::endsWith(fname, ".gz");
+
+    if(StringHelper::endsWith(fname, ".zst"))
+        throw std::invalid_argument("zstd output is not supported, use .gz instead");
+
+#if defined(_WIN32) // Windows
+    fd = _open(fname.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0666);
+#else // POSIX
+    fd = open(fname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+#endif // _WIN32
+
+    if(fd == -1)
+        throw std::runtime_error("could not open " + fname);
+
+    try
+    {
+        if(gzip) compressor.reset(new Compressor(fd, fname, background));
+    }
+    catch(...)
+    {
+#if defined(_WIN32) // Windows
+        _close(fd);
+#else // POSIX
+        close(fd);
+#endif // _WIN32
+        throw;
+    }
+}
+
+/**
+ * @brief Collect the output in the string. Contents
+ * of the string are complete after the sink is flushed
+ *
+ * @param str String that receives the output
+ */
+OutputSink::OutputSink(std::string& str) :
+    fd(-1),                     // No file
+    ownsFd(false),              // No file
+    buffer(BUFFER_SIZE),        // Buffer is allocated once
+    used(0),                    // Buffer is empty
+    compressor(),               // Strings are not compressed
+    target(&str)                // Output goes to the string
+#if !defined(_WIN32)
+    , pending(0)                // Nothing is covered by slices
+    , slices()                  // Slices to be written
+#endif // _WIN32
+{ }
+
+/**
+ * @brief Flush the output and close the file. Errors are
+ * ignored here, they are reported by finish()
+ *
+ */
+OutputSink::~OutputSink(void)
+{
+    try
+    {
+        finish();
+    }
+    catch(...)
+    {
+        // Output is incomplete only when an error is already reported
+    }
+
+    // The background thread must stop before the file is closed
+    compressor.reset();
+
+#if defined(_WIN32) // Windows
+    if(ownsFd) _close(fd);
+#else // POSIX
+    if(ownsFd) close(fd);
+#endif // _WIN32
+}
+
+#if !defined(_WIN32) // POSIX
+/**
+ * @brief Add the pending part of the buffer to slices
+ *
+ */
+void OutputSink::closePending(void)
+{
+    if(used == pending) return;
+
+    iovec slice;
+    slice.iov_base = buffer.data() + pending;
+    slice.iov_len = used - pending;
+    slices.push_back(slice);
+    pending = used;
+}
+#endif // _WIN32
+
+/**
+ * @brief Write bytes directly to the file descriptor,
+ * to the compressor if the output is compressed,
+ * or to the target string
+ *
+ * @param data Pointer to the first byte
+ * @param size Number of bytes
+ */
+void OutputSink::writeAll(const char* data, std::size_t size)
+{
+    if(compressor)
+    {
+        compressor->write(data, size);
+        return;
+    }
+
+    if(target != nullptr)
+    {
+        target->append(data, size);
+        return;
+    }
+
+    while(size > 0)
+    {
+#if defined(_WIN32) // Windows
+        const int count = _write(fd, data, static_cast<unsigned int>(
+            size < INT_MAX ? size : INT_MAX));
+#else // POSIX
+        const ssize_t count = ::write(fd, data, size);
+#endif // _WIN32
+
+        if(count < 0)
+        {
+            if(errno == EINTR) continue;
+            throw std::runtime_error(std::string("could not write output: ") +
+                                     std::strerror(errno));
+        }
+
+        data += count;
+        size -= count;
+    }
+}
+
+/**
+ * @brief Copy bytes into the buffer
+ *
+ * @param data Pointer to the first byte
+ * @param size Number of bytes
+ */
+void OutputSink::write(const char* data, std::size_t size)
+{
+    if(size > buffer.size() - used)
+    {
+        flush();
+
+        // Data that does not fit into the empty buffer is written directly
+        if(size > buffer.size())
+        {
+            writeAll(data, size);
+            return;
+        }
+    }
+
+    std::memcpy(buffer.data() + used, data, size);
+    used += size;
+}
+
+/**
+ * @brief Write the line without copying it. The memory the line
+ * refers to must stay valid until the sink is flushed
+ *
+ * @param line Line
+ */
+void OutputSink::write(const LineView& line)
+{
+#if defined(_WIN32) // Windows
+    write(line.getData(), line.getLength());
+#else // POSIX
+    // Short lines are cheaper to copy than to gather.
+    // Compressed output and strings are always copied,
+    // they need contiguous blocks anyway
+    if(line.getLength() < MIN_VIEW_LENGTH || compressor || target != nullptr)
+    {
+        write(line.getData(), line.getLength());
+        return;
+    }
+
+    closePending();
+
+    iovec slice;
+    slice.iov_base = const_cast<char*>(line.getData());
+    slice.iov_len = line.getLength();
+    slices.push_back(slice);
+
+    // Leave room for the pending part of the buffer
+    if(slices.size() + 1 >= IOV_MAX)
+        flush();
+#endif // _WIN32
+}
+
+/**
+ * @brief Write everything buffered so far to the file descriptor
+ *
+ */
+void OutputSink::flush(void)
+{
+#if defined(_WIN32) // Windows
+    writeAll(buffer.data(), used);
+#else // POSIX
+    // Compressed output and strings have no slices
+    if(compressor || target != nullptr)
+    {
+        writeAll(buffer.data(), used);
+        used = 0;
+        return;
+    }
+
+    closePending();
+
+    std::size_t first = 0; // First slice that is not written completely
+    ssize_t count;
+
+    while(first < slices.size())
+    {
+        count = writev(fd, &slices[first],
+            std::min<std::size_t>(slices.size() - first, IOV_MAX));
+
+        if(count < 0)
+        {
+            if(errno == EINTR) continue;
+            throw std::runtime_error(std::string("could not write output: ") +
+                                     std::strerror(errno));
+        }
+
+        // Skip slices that were written and adjust the partially written one
+        while(first < slices.size() &&
+              static_cast<std::size_t>(count) >= slices[first].iov_len)
+        {
+            count -= slices[first].iov_len;
+            first++;
+        }
+
+        if(count > 0)
+        {
+            slices[first].iov_base = static_cast<char*>(slices[first].iov_base) + count;
+            slices[first].iov_len -= count;
+        }
+    }
+
+    slices.clear();
+    pending = 0;
+#endif // _WIN32
+
+    used = 0;
+}
+
+/**
+ * @brief Write everything buffered so far and end the compressed
+ * stream. Called when the output is complete, so that errors
+ * are reported instead of being lost when the sink is destroyed
+ *
+ */
+void OutputSink::finish(void)
+{
+    flush();
+
+    // The gzip trailer is written after everything else
+    if(compressor) compressor->finish();
+}
+
+/**
+ * @brief Write the character
+ *
+ * @param c Character
+ * @return Output sink
+ */
+OutputSink& OutputSink::operator<<(char c)
+{
+    if(used == buffer.size()) flush();
+
+    buffer[used++] = c;
+    return *this;
+}
+
+/**
+ * @brief Write the null-terminated string
+ *
+ * @param str String
+ * @return Output sink
+ */
+OutputSink& OutputSink::operator<<(const char* str)
+{
+    write(str, std::strlen(str));
+    return *this;
+}
+
+/**
+ * @brief Write the string
+ *
+ * @param str String
+ * @return Output sink
+ */
+OutputSink& OutputSink::operator<<(const std::string& str)
+{
+    write(str.data(), str.size());
+    return *this;
+}
+
+/**
+ * @brief Write the number in decimal
+ *
+ * @param number Number
+ * @return Output sink
+ */
+OutputSink& OutputSink::operator<<(unsigned int number)
+{
+    char digits[16];
+    char* first = digits + sizeof(digits);
+
+    // Digits are produced from the last one
+    do
+    {
+        *--first = '0' + number % 10;
+        number /= 10;
+    } while(number > 0);
+
+    write(first, digits + sizeof(digits) - first);
+    return *this;
+}
+
+/**
+ * @brief Write the line without copying it
+ *
+ * @param line Line
+ * @return Output sink
+ */
+OutputSink& OutputSink::operator<<(const LineView& line)
+{
+    write(line);
+    return *this;
+}
\ No newline at end of file
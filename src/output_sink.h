@@ -0,0 +1,215 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OUTPUT_SINK_H
+#define OUTPUT_SINK_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "compressor.h"
+#include "line_view.h"
+
+// POSIX-specific
+#if !defined(_WIN32)
+#include <sys/uio.h>
+#endif // _WIN32
+
+/**
+ * @brief Class that writes output to a file descriptor through a buffer.
+ * Long lines are not copied into the buffer, they are gathered
+ * from the memory they refer to when the buffer is flushed.
+ * Files with the ".gz" extension are compressed with gzip.
+ * Output can also be collected in a string
+ *
+ */
+class OutputSink
+{
+    private:
+        /**
+         * @brief Size of the buffer in bytes
+         *
+         */
+        static const std::size_t BUFFER_SIZE = 262144;
+        /**
+         * @brief Lines shorter than this are copied into the buffer
+         *
+         */
+        static const std::size_t MIN_VIEW_LENGTH = 128;
+        /**
+         * @brief File descriptor the output is written to
+         *
+         */
+        int fd;
+        /**
+         * @brief Whether the file descriptor is closed by the sink
+         *
+         */
+        bool ownsFd;
+        /**
+         * @brief Buffer for output. It is never reallocated,
+         * so slices can point into it
+         *
+         */
+        std::vector<char> buffer;
+        /**
+         * @brief Number of bytes used in the buffer
+         *
+         */
+        std::size_t used;
+        /**
+         * @brief Compressor of the output, if the file is compressed
+         *
+         */
+        std::unique_ptr<Compressor> compressor;
+        /**
+         * @brief String the output is collected in, if any
+         *
+         */
+        std::string* target;
+#if !defined(_WIN32) // POSIX
+        /**
+         * @brief Start of the part of the buffer that is not covered by slices
+         *
+         */
+        std::size_t pending;
+        /**
+         * @brief Parts of the buffer and lines to be written in order
+         *
+         */
+        std::vector<iovec> slices;
+        /**
+         * @brief Add the pending part of the buffer to slices
+         *
+         */
+        void closePending(void);
+#endif // _WIN32
+        /**
+         * @brief Write bytes directly to the file descriptor,
+         * to the compressor if the output is compressed,
+         * or to the target string
+         *
+         * @param data Pointer to the first byte
+         * @param size Number of bytes
+         */
+        void writeAll(const char* data, std::size_t size);
+
+    public:
+        /**
+         * @brief Write to the standard output
+         *
+         */
+        OutputSink(void);
+        /**
+         * @brief Create or truncate the file and write to it.
+         * The output is compressed if the file has the ".gz" extension
+         *
+         * @param fname Filename
+         * @param background Whether to compress on a separate thread
+         */
+        OutputSink(const std::string& fname, bool background);
+        /**
+         * @brief Collect the output in the string. Contents
+         * of the string are complete after the sink is flushed
+         *
+         * @param str String that receives the output
+         */
+        explicit OutputSink(std::string& str);
+        /**
+         * @brief Flush the output and close the file. Errors are
+         * ignored here, they are reported by finish()
+         *
+         */
+        ~OutputSink(void);
+        /**
+         * @brief Sink owns the file descriptor, so it cannot be copied
+         *
+         */
+        OutputSink(const OutputSink&) = delete;
+        OutputSink& operator=(const OutputSink&) = delete;
+        /**
+         * @brief Copy bytes into the buffer
+         *
+         * @param data Pointer to the first byte
+         * @param size Number of bytes
+         */
+        void write(const char* data, std::size_t size);
+        /**
+         * @brief Write the line without copying it. The memory the line
+         * refers to must stay valid until the sink is flushed
+         *
+         * @param line Line
+         */
+        void write(const LineView& line);
+        /**
+         * @brief Write everything buffered so far to the file descriptor
+         *
+         */
+        void flush(void);
+        /**
+         * @brief Write everything buffered so far and end the compressed
+         * stream. Called when the output is complete, so that errors
+         * are reported instead of being lost when the sink is destroyed
+         *
+         */
+        void finish(void);
+        /**
+         * @brief Write the character
+         *
+         * @param c Character
+         * @return Output sink
+         */
+        OutputSink& operator<<(char c);
+        /**
+         * @brief Write the null-terminated string
+         *
+         * @param str String
+         * @return Output sink
+         */
+        OutputSink& operator<<(const char* str);
+        /**
+         * @brief Write the string
+         *
+         * @param str String
+         * @return Output sink
+         */
+        OutputSink& operator<<(const std::string& str);
+        /**
+         * @brief Write the number in decimal
+         *
+         * @param number Number
+         * @return Output sink
+         */
+        OutputSink& operator<<(unsigned int number);
+        /**
+         * @brief Write the line without copying it
+         *
+         * @param line Line
+         * @return Output sink
+         */
+        OutputSink& operator<<(const LineView& line);
+};
+
+#endif // OUTPUT_SINK_H
\ No newline at end of file
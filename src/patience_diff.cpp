@@ -0,0 +1,223 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "patience_diff.h"
+
+#include <algorithm>
+
+/**
+ * @brief Initialize parameters with specified values
+ *
+ * @param original IDs of lines from the original file
+ * @param modified IDs of lines from the modified file
+ * @param idCount Number of unique IDs in both files
+ */
+PatienceDiff::PatienceDiff(const std::vector<std::uint32_t>& original,
+                           const std::vector<std::uint32_t>& modified,
+                           std::uint32_t idCount) :
+                           original(original),
+                           modified(modified),
+                           myers(original, modified),
+                           countOld(idCount, 0),
+                           countNew(idCount, 0),
+                           positionOld(idCount, 0) { }
+
+/**
+ * @brief Find the longest increasing subsequence of lines
+ * that are unique in both ranges
+ *
+ * @param aLo Start of the range in the original file
+ * @param aHi End of the range in the original file
+ * @param bLo Start of the range in the modified file
+ * @param bHi End of the range in the modified file
+ * @param anchorsOld Positions of anchors in the original file
+ * @param anchorsNew Positions of anchors in the modified file
+ */
+void PatienceDiff::findAnchors(int aLo, int aHi, int bLo, int bHi,
+                               std::vector<int>& anchorsOld,
+                               std::vector<int>& anchorsNew)
+{
+    // Unique lines in order of the modified file
+    std::vector<int> uniqueOld;
+    std::vector<int> uniqueNew;
+    int i;
+
+    anchorsOld.clear();
+    anchorsNew.clear();
+
+    // Count occurrences of each line in both ranges
+    for(i = aLo; i < aHi; i++)
+    {
+        countOld[original[i]]++;
+        positionOld[original[i]] = i;
+    }
+
+    for(i = bLo; i < bHi; i++)
+        countNew[modified[i]]++;
+
+    for(i = bLo; i < bHi; i++)
+    {
+        if(countOld[modified[i]] == 1 && countNew[modified[i]] == 1)
+        {
+            uniqueOld.push_back(positionOld[modified[i]]);
+            uniqueNew.push_back(i);
+        }
+    }
+
+    // Reset counters for the next range
+    for(i = aLo; i < aHi; i++) countOld[original[i]] = 0;
+    for(i = bLo; i < bHi; i++) countNew[modified[i]] = 0;
+
+    if(uniqueOld.empty()) return;
+
+    // Patience sorting. Each pile keeps the index of its top card,
+    // and each card points to the top of the previous pile
+    const int count = uniqueOld.size();
+    std::vector<int> piles;
+    std::vector<int> tops;
+    std::vector<int> previous(count, -1);
+    std::vector<int>::iterator it;
+
+    for(i = 0; i < count; i++)
+    {
+        // Find the leftmost pile with the top greater than the card
+        it = std::lower_bound(tops.begin(), tops.end(), uniqueOld[i]);
+
+        if(it != tops.begin())
+            previous[i] = piles[it - tops.begin() - 1];
+
+        if(it == tops.end())
+        {
+            tops.push_back(uniqueOld[i]);
+            piles.push_back(i);
+        }
+        else
+        {
+            *it = uniqueOld[i];
+            piles[it - tops.begin()] = i;
+        }
+    }
+
+    // Follow the pointers from the top of the last pile
+    for(i = piles.back(); i != -1; i = previous[i])
+    {
+        anchorsOld.push_back(uniqueOld[i]);
+        anchorsNew.push_back(uniqueNew[i]);
+    }
+
+    std::reverse(anchorsOld.begin(), anchorsOld.end());
+    std::reverse(anchorsNew.begin(), anchorsNew.end());
+}
+
+/**
+ * @brief Calculate the difference between ranges of two sequences.
+ * Only flags of lines within the ranges are changed
+ *
+ * @param aLo Start of the range in the original file
+ * @param aHi End of the range in the original file
+ * @param bLo Start of the range in the modified file
+ * @param bHi End of the range in the modified file
+ * @param removed Flags of removed lines in the original file
+ * @param inserted Flags of inserted lines in the modified file
+ */
+void PatienceDiff::calculate(int aLo, int aHi, int bLo, int bHi,
+                             std::vector<char>& removed,
+                             std::vector<char>& inserted)
+{
+    // Ranges that still have to be solved. A stack is used
+    // instead of recursion, so deep nesting of gaps
+    // cannot overflow the call stack
+    std::vector<int> ranges = { aLo, aHi, bLo, bHi };
+    std::vector<int> anchorsOld;
+    std::vector<int> anchorsNew;
+    std::size_t i;
+    int x, y;
+
+    while(!ranges.empty())
+    {
+        bHi = ranges.back(); ranges.pop_back();
+        bLo = ranges.back(); ranges.pop_back();
+        aHi = ranges.back(); ranges.pop_back();
+        aLo = ranges.back(); ranges.pop_back();
+
+        // Skip unchanged lines at the start of both ranges
+        while(aLo < aHi && bLo < bHi && original[aLo] == modified[bLo])
+        {
+            aLo++;
+            bLo++;
+        }
+
+        // Skip unchanged lines at the end of both ranges
+        while(aLo < aHi && bLo < bHi && original[aHi - 1] == modified[bHi - 1])
+        {
+            aHi--;
+            bHi--;
+        }
+
+        if(aLo == aHi) // All remaining lines were inserted
+        {
+            std::fill(inserted.begin() + bLo, inserted.begin() + bHi, 1);
+            continue;
+        }
+
+        if(bLo == bHi) // All remaining lines were removed
+        {
+            std::fill(removed.begin() + aLo, removed.begin() + aHi, 1);
+            continue;
+        }
+
+        findAnchors(aLo, aHi, bLo, bHi, anchorsOld, anchorsNew);
+
+        if(anchorsOld.empty())
+        {
+            // No unique lines to align on
+            myers.calculate(aLo, aHi, bLo, bHi, removed, inserted);
+            continue;
+        }
+
+        // Solve gaps between anchors. Anchors themselves are unchanged
+        x = aLo;
+        y = bLo;
+
+        for(i = 0; i < anchorsOld.size(); i++)
+        {
+            ranges.insert(ranges.end(), { x, anchorsOld[i], y, anchorsNew[i] });
+            x = anchorsOld[i] + 1;
+            y = anchorsNew[i] + 1;
+        }
+
+        ranges.insert(ranges.end(), { x, aHi, y, bHi });
+    }
+}
+
+/**
+ * @brief Set the number of steps of the Myers search for ranges
+ * that cannot be split, after which the shortest edit script
+ * is no longer searched for
+ *
+ * @param costLimit Maximum number of steps, INT_MAX for the exact search
+ */
+void PatienceDiff::setCostLimit(int costLimit)
+{
+    myers.setCostLimit(costLimit);
+}
\ No newline at end of file
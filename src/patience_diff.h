@@ -0,0 +1,123 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PATIENCE_DIFF_H
+#define PATIENCE_DIFF_H
+
+#include <cstdint>
+#include <vector>
+
+#include "myers_diff.h"
+
+/**
+ * @brief Class for calculating the difference between two sequences
+ * using the patience algorithm. Lines that occur exactly once in both
+ * ranges are used as anchors, the longest increasing subsequence of
+ * anchors is matched and the gaps between them are solved recursively.
+ * Ranges without unique lines are solved with the Myers algorithm
+ *
+ */
+class PatienceDiff
+{
+    private:
+        /**
+         * @brief IDs of lines from the original file
+         *
+         */
+        const std::vector<std::uint32_t>& original;
+        /**
+         * @brief IDs of lines from the modified file
+         *
+         */
+        const std::vector<std::uint32_t>& modified;
+        /**
+         * @brief Algorithm for ranges without unique lines
+         *
+         */
+        MyersDiff myers;
+        /**
+         * @brief Number of occurrences of each ID in the original range
+         *
+         */
+        std::vector<std::uint32_t> countOld;
+        /**
+         * @brief Number of occurrences of each ID in the modified range
+         *
+         */
+        std::vector<std::uint32_t> countNew;
+        /**
+         * @brief Last position of each ID in the original range
+         *
+         */
+        std::vector<int> positionOld;
+        /**
+         * @brief Find the longest increasing subsequence of lines
+         * that are unique in both ranges
+         *
+         * @param aLo Start of the range in the original file
+         * @param aHi End of the range in the original file
+         * @param bLo Start of the range in the modified file
+         * @param bHi End of the range in the modified file
+         * @param anchorsOld Positions of anchors in the original file
+         * @param anchorsNew Positions of anchors in the modified file
+         */
+        void findAnchors(int aLo, int aHi, int bLo, int bHi,
+                         std::vector<int>& anchorsOld,
+                         std::vector<int>& anchorsNew);
+
+    public:
+        /**
+         * @brief Initialize parameters with specified values
+         *
+         * @param original IDs of lines from the original file
+         * @param modified IDs of lines from the modified file
+         * @param idCount Number of unique IDs in both files
+         */
+        PatienceDiff(const std::vector<std::uint32_t>& original,
+                     const std::vector<std::uint32_t>& modified,
+                     std::uint32_t idCount);
+        /**
+         * @brief Calculate the difference between ranges of two sequences.
+         * Only flags of lines within the ranges are changed
+         *
+         * @param aLo Start of the range in the original file
+         * @param aHi End of the range in the original file
+         * @param bLo Start of the range in the modified file
+         * @param bHi End of the range in the modified file
+         * @param removed Flags of removed lines in the original file
+         * @param inserted Flags of inserted lines in the modified file
+         */
+        void calculate(int aLo, int aHi, int bLo, int bHi,
+                       std::vector<char>& removed,
+                       std::vector<char>& inserted);
+        /**
+         * @brief Set the number of steps of the Myers search for ranges
+         * that cannot be split, after which the shortest edit script
+         * is no longer searched for
+         *
+         * @param costLimit Maximum number of steps, INT_MAX for the exact search
+         */
+        void setCostLimit(int costLimit);
+};
+
+#endif // PATIENCE_DIFF_H
\ No newline at end of file
@@ -0,0 +1,314 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "result_cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "file_helper.h"
+#include "sha256.h"
+
+#if defined(_WIN32) // Windows
+#include <direct.h>
+#include <sys/stat.h>
+#include <sys/utime.h>
+#else // POSIX
+#include <sys/stat.h>
+#include <utime.h>
+#endif // _WIN32
+
+namespace
+{
+    /**
+     * @brief Bytes at the beginning of each entry, including the version of the format
+     *
+     */
+    const std::string MAGIC = "CDIFFES1";
+
+    /**
+     * @brief Calculate the digest of contents of the file
+     *
+     * @param file File
+     * @return SHA-256 digest
+     */
+    std::string getDigest(const MappedFile& file)
+    {
+        Sha256 sha;
+        sha.update(file.getData(), file.getSize());
+        return sha.finish();
+    }
+
+    /**
+     * @brief Check if the name is the name of an entry
+     *
+     * @param name Name of the file
+     * @return true if the name consists of 64 hexadecimal digits, false otherwise
+     */
+    bool isEntryName(const std::string& name)
+    {
+        return name.size() == 2 * Sha256::DIGEST_SIZE &&
+               name.find_first_not_of("0123456789abcdef") == std::string::npos;
+    }
+}
+
+/**
+ * @brief Create the directory of the cache if it does not exist
+ *
+ * @param directory Directory with entries
+ * @param capacity Maximum total size of entries in bytes
+ */
+ResultCache::ResultCache(const std::string& directory, std::uint64_t capacity) :
+    directory(directory),   // Directory with entries
+    capacity(capacity),     // Maximum total size of entries
+    totalSize(0),           // Counted on the first write
+    scanned(false),         // Directory is scanned on the first write
+    lock()                  // Lock for the total size
+{
+    if(FileHelper::isDirectory(directory)) return;
+
+#if defined(_WIN32) // Windows
+    const int created = _mkdir(directory.c_str());
+#else // POSIX
+    const int created = mkdir(directory.c_str(), 0777);
+#endif // _WIN32
+
+    // Another process may have created the directory in the meantime
+    if(created != 0 && !FileHelper::isDirectory(directory))
+        throw std::runtime_error("could not create the cache directory " + directory);
+}
+
+/**
+ * @brief Get the path to the entry
+ *
+ * @param key Key of the entry
+ * @return Path to the entry
+ */
+std::string ResultCache::getPath(const std::string& key) const
+{
+    return directory + '/' + key;
+}
+
+/**
+ * @brief Scan the directory to get the total size and, if it exceeds
+ * the capacity, remove the least recently used entries until it drops
+ * below 7/8 of the capacity, so the next scan is needed only after
+ * more entries are written
+ *
+ */
+void ResultCache::evict(void)
+{
+    std::vector<std::string> names;
+    // Modification time and size of each entry
+    std::vector<std::pair<std::pair<long long, std::uint64_t>, std::string>> entries;
+    const std::uint64_t limit = capacity - capacity / 8;
+
+    totalSize = 0;
+    scanned = true;
+
+    FileHelper::listFiles(directory, names);
+
+    for(const std::string& name : names)
+    {
+        // Temporary files belong to processes that are writing them
+        if(!isEntryName(name)) continue;
+
+#if defined(_WIN32) // Windows
+        struct _stat64 attr;
+
+        if(_stat64(getPath(name).c_str(), &attr) != 0) continue;
+#else // POSIX
+        struct stat attr;
+
+        if(stat(getPath(name).c_str(), &attr) != 0) continue;
+#endif // _WIN32
+
+        entries.push_back(std::make_pair(std::make_pair(
+            static_cast<long long>(attr.st_mtime), static_cast<std::uint64_t>(attr.st_size)),
+            name));
+        totalSize += attr.st_size;
+    }
+
+    if(totalSize <= capacity) return;
+
+    // Entries are touched when they are used, so the oldest go first
+    std::sort(entries.begin(), entries.end());
+
+    for(std::size_t i = 0; i < entries.size() && totalSize > limit; i++)
+    {
+        // Another process may have removed the entry already
+        std::remove(getPath(entries[i].second).c_str());
+        totalSize -= entries[i].first.second;
+    }
+}
+
+/**
+ * @brief Get the key of the entry for both files
+ *
+ * @param originalFile Original file
+ * @param modifiedFile Modified file
+ * @param options Program options
+ * @return Key of the entry as a hexadecimal string
+ */
+std::string ResultCache::getKey(const MappedFile& originalFile,
+                                const MappedFile& modifiedFile,
+                                const Options& options) const
+{
+    std::string originalDigest, modifiedDigest;
+
+    if(options.getThreadCount() > 1)
+    {
+        // Both files are hashed in parallel
+        std::future<std::string> modifiedHasher = std::async(std::launch::async,
+            [&modifiedFile]() { return getDigest(modifiedFile); });
+
+        originalDigest = getDigest(originalFile);
+        modifiedDigest = modifiedHasher.get();
+    }
+    else
+    {
+        originalDigest = getDigest(originalFile);
+        modifiedDigest = getDigest(modifiedFile);
+    }
+
+    // Only options that change the edit script are part of the key
+    const std::string settings = MAGIC + ' ' + options.getScriptSignature() + '\n';
+
+    Sha256 sha;
+    sha.update(settings.data(), settings.size());
+    sha.update(originalDigest.data(), originalDigest.size());
+    sha.update(modifiedDigest.data(), modifiedDigest.size());
+
+    const std::string digest = sha.finish();
+    const char* digits = "0123456789abcdef";
+    std::string key;
+
+    for(unsigned char c : digest)
+    {
+        key += digits[c >> 4];
+        key += digits[c & 0x0F];
+    }
+
+    return key;
+}
+
+/**
+ * @brief Read the edit script from the cache. Entries that are damaged
+ * or do not match the number of lines are ignored
+ *
+ * @param key Key of the entry
+ * @param originalCount Number of lines in the original file
+ * @param modifiedCount Number of lines in the modified file
+ * @param script Edit script that receives the entry
+ * @return true if the entry was found, false otherwise
+ */
+bool ResultCache::load(const std::string& key, std::size_t originalCount,
+                       std::size_t modifiedCount, EditScript& script) const
+{
+    const std::string path = getPath(key);
+    std::ifstream file(path, std::ios::binary);
+
+    if(!file.is_open()) return false;
+
+    const std::string data((std::istreambuf_iterator<char>(file)),
+                           std::istreambuf_iterator<char>());
+
+    if(file.bad() || data.compare(0, MAGIC.size(), MAGIC) != 0) return false;
+
+    std::size_t pos = MAGIC.size();
+
+    if(!script.decode(data, pos, originalCount, modifiedCount) || pos != data.size())
+    {
+        script.clear();
+        return false;
+    }
+
+    // The modification time tells which entries were used recently
+#if defined(_WIN32) // Windows
+    _utime(path.c_str(), nullptr);
+#else // POSIX
+    utime(path.c_str(), nullptr);
+#endif // _WIN32
+
+    return true;
+}
+
+/**
+ * @brief Write the edit script to the cache. The cache only saves
+ * time, so failures to write it are ignored
+ *
+ * @param key Key of the entry
+ * @param originalCount Number of lines in the original file
+ * @param modifiedCount Number of lines in the modified file
+ * @param script Edit script
+ */
+void ResultCache::store(const std::string& key, std::size_t originalCount,
+                        std::size_t modifiedCount, const EditScript& script)
+{
+    std::string data = MAGIC;
+
+    script.encode(originalCount, modifiedCount, data);
+
+    try
+    {
+        // Readers see either no entry or the whole entry
+        std::random_device random;
+        const std::string path = getPath(key);
+        const std::string temp = path + '.' + std::to_string(random()) + ".tmp";
+
+        {
+            std::ofstream file(temp, std::ios::binary);
+            file.write(data.data(), data.size());
+            file.close();
+
+            if(file.fail())
+            {
+                std::remove(temp.c_str());
+                return;
+            }
+        }
+
+        // Fails on Windows if another process has written the entry
+        if(std::rename(temp.c_str(), path.c_str()) != 0)
+        {
+            std::remove(temp.c_str());
+            return;
+        }
+
+        // Other processes are noticed only when the directory is scanned,
+        // so the cache may exceed the capacity until the next scan
+        std::lock_guard<std::mutex> guard(lock);
+
+        totalSize += data.size();
+
+        if(!scanned || totalSize > capacity) evict();
+    }
+    catch(const std::exception&) { }
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "edit_script.h"
+#include "mapped_file.h"
+#include "options.h"
+
+/**
+ * @brief On-disk cache of calculated edit scripts. An entry is identified
+ * by SHA-256 digests of contents of both files and options that change the
+ * edit script, so output options such as the number of context lines are
+ * applied to cached scripts as well. Entries are written to temporary files
+ * and renamed, so several processes can share the cache. The least recently
+ * used entries are removed when the total size exceeds the capacity. The
+ * directory is scanned on the first write, then written entries are counted
+ * in memory and the directory is scanned again only to remove entries
+ *
+ */
+class ResultCache
+{
+    private:
+        /**
+         * @brief Directory with entries
+         *
+         */
+        std::string directory;
+        /**
+         * @brief Maximum total size of entries in bytes
+         *
+         */
+        std::uint64_t capacity;
+        /**
+         * @brief Approximate total size of entries in bytes. Entries
+         * written by other processes are counted only after a scan
+         *
+         */
+        std::uint64_t totalSize;
+        /**
+         * @brief Whether the directory was scanned to get the total size
+         *
+         */
+        bool scanned;
+        /**
+         * @brief Lock for the total size, entries may be written on several threads
+         *
+         */
+        std::mutex lock;
+        /**
+         * @brief Get the path to the entry
+         *
+         * @param key Key of the entry
+         * @return Path to the entry
+         */
+        std::string getPath(const std::string& key) const;
+        /**
+         * @brief Scan the directory to get the total size and, if it exceeds
+         * the capacity, remove the least recently used entries until it drops
+         * below 7/8 of the capacity, so the next scan is needed only after
+         * more entries are written
+         *
+         */
+        void evict(void);
+
+    public:
+        /**
+         * @brief Create the directory of the cache if it does not exist
+         *
+         * @param directory Directory with entries
+         * @param capacity Maximum total size of entries in bytes
+         */
+        ResultCache(const std::string& directory, std::uint64_t capacity);
+        /**
+         * @brief Get the key of the entry for both files
+         *
+         * @param originalFile Original file
+         * @param modifiedFile Modified file
+         * @param options Program options
+         * @return Key of the entry as a hexadecimal string
+         */
+        std::string getKey(const MappedFile& originalFile,
+                           const MappedFile& modifiedFile,
+                           const Options& options) const;
+        /**
+         * @brief Read the edit script from the cache. Entries that are damaged
+         * or do not match the number of lines are ignored
+         *
+         * @param key Key of the entry
+         * @param originalCount Number of lines in the original file
+         * @param modifiedCount Number of lines in the modified file
+         * @param script Edit script that receives the entry
+         * @return true if the entry was found, false otherwise
+         */
+        bool load(const std::string& key, std::size_t originalCount,
+                  std::size_t modifiedCount, EditScript& script) const;
+        /**
+         * @brief Write the edit script to the cache. The cache only saves
+         * time, so failures to write it are ignored
+         *
+         * @param key Key of the entry
+         * @param originalCount Number of lines in the original file
+         * @param modifiedCount Number of lines in the modified file
+         * @param script Edit script
+         */
+        void store(const std::string& key, std::size_t originalCount,
+                   std::size_t modifiedCount, const EditScript& script);
+};
+
+#endif // RESULT_CACHE_H
\ No newline at end of file
@@ -0,0 +1,278 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "sha256.h"
+
+#include <cstring>
+
+// SHA extensions are available only on x86 processors
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHA256_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    /**
+     * @brief Round constants
+     *
+     */
+    const std::uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    /**
+     * @brief Rotate bits to the right
+     *
+     * @param x Value
+     * @param n Number of bits
+     * @return Rotated value
+     */
+    inline std::uint32_t rotr(std::uint32_t x, unsigned int n)
+    {
+        return (x >> n) | (x << (32 - n));
+    }
+
+#if defined(SHA256_X86)
+    /**
+     * @brief Process whole blocks with SHA extensions. Each instruction
+     * makes two rounds, the message schedule is calculated four words
+     * at a time
+     *
+     * @param state Intermediate hash value
+     * @param data Blocks
+     * @param count Number of blocks
+     */
+    __attribute__((target("sha,sse4.1")))
+    void transformShaNi(std::uint32_t* state, const unsigned char* data, std::size_t count)
+    {
+        // Words of the message are stored in big-endian order
+        const __m128i order = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+        __m128i abef, cdgh, abefSaved, cdghSaved, words, next, message[4];
+        int i;
+
+        // Instructions keep the state as ABEF and CDGH
+        __m128i dcba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+        __m128i hgfe = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4));
+        dcba = _mm_shuffle_epi32(dcba, 0xB1);
+        hgfe = _mm_shuffle_epi32(hgfe, 0x1B);
+        abef = _mm_alignr_epi8(dcba, hgfe, 8);
+        cdgh = _mm_blend_epi16(hgfe, dcba, 0xF0);
+
+        for(; count > 0; count--, data += 64)
+        {
+            abefSaved = abef;
+            cdghSaved = cdgh;
+
+            for(i = 0; i < 16; i++)
+            {
+                if(i < 4)
+                {
+                    message[i] = _mm_shuffle_epi8(_mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(data + 16 * i)), order);
+                }
+                else
+                {
+                    next = _mm_sha256msg1_epu32(message[i & 3], message[(i + 1) & 3]);
+                    next = _mm_add_epi32(next, _mm_alignr_epi8(message[(i + 3) & 3],
+                                                               message[(i + 2) & 3], 4));
+                    message[i & 3] = _mm_sha256msg2_epu32(next, message[(i + 3) & 3]);
+                }
+
+                words = _mm_add_epi32(message[i & 3],
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(K + 4 * i)));
+                cdgh = _mm_sha256rnds2_epu32(cdgh, abef, words);
+                words = _mm_shuffle_epi32(words, 0x0E);
+                abef = _mm_sha256rnds2_epu32(abef, cdgh, words);
+            }
+
+            abef = _mm_add_epi32(abef, abefSaved);
+            cdgh = _mm_add_epi32(cdgh, cdghSaved);
+        }
+
+        // Restore the order of words
+        const __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+        const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(feba, dchg, 0xF0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+    }
+#endif
+}
+
+/**
+ * @brief Initialize the hash value
+ *
+ */
+Sha256::Sha256(void) :
+    state{ 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+           0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 },
+    block(),            // Block is empty
+    blockLength(0),     // Block is empty
+    totalLength(0) { }  // Nothing is passed yet
+
+/**
+ * @brief Process whole blocks
+ *
+ * @param data Blocks
+ * @param count Number of blocks
+ */
+void Sha256::transform(const unsigned char* data, std::size_t count)
+{
+#if defined(SHA256_X86)
+    // Processor is checked only once
+    static const bool shaNi = __builtin_cpu_supports("sha") &&
+                              __builtin_cpu_supports("sse4.1");
+
+    if(shaNi)
+    {
+        transformShaNi(state, data, count);
+        return;
+    }
+#endif
+
+    std::uint32_t w[64];
+    std::uint32_t a, b, c, d, e, f, g, h, t1, t2;
+    int i;
+
+    for(; count > 0; count--, data += BLOCK_SIZE)
+    {
+        // Words are stored in big-endian order
+        for(i = 0; i < 16; i++)
+            w[i] = (std::uint32_t(data[4 * i]) << 24) | (std::uint32_t(data[4 * i + 1]) << 16) |
+                   (std::uint32_t(data[4 * i + 2]) << 8) | std::uint32_t(data[4 * i + 3]);
+
+        for(i = 16; i < 64; i++)
+            w[i] = w[i - 16] + (rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3)) +
+                   w[i - 7] + (rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10));
+
+        a = state[0];
+        b = state[1];
+        c = state[2];
+        d = state[3];
+        e = state[4];
+        f = state[5];
+        g = state[6];
+        h = state[7];
+
+        for(i = 0; i < 64; i++)
+        {
+            t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+            t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+/**
+ * @brief Add data to the digest
+ *
+ * @param data Data
+ * @param size Size of data in bytes
+ */
+void Sha256::update(const void* data, std::size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    std::size_t n;
+
+    totalLength += size;
+
+    // Fill the block left from the previous call
+    if(blockLength > 0)
+    {
+        n = (size < BLOCK_SIZE - blockLength) ? size : BLOCK_SIZE - blockLength;
+        std::memcpy(block + blockLength, bytes, n);
+        blockLength += n;
+        bytes += n;
+        size -= n;
+
+        if(blockLength < BLOCK_SIZE) return;
+
+        transform(block, 1);
+        blockLength = 0;
+    }
+
+    // Whole blocks are processed without copying
+    transform(bytes, size / BLOCK_SIZE);
+    bytes += size - size % BLOCK_SIZE;
+    size %= BLOCK_SIZE;
+
+    std::memcpy(block, bytes, size);
+    blockLength = size;
+}
+
+/**
+ * @brief Finish the digest. No data can be added afterwards
+ *
+ * @return Digest as a string of DIGEST_SIZE bytes
+ */
+std::string Sha256::finish(void)
+{
+    const std::uint64_t bits = totalLength * 8;
+    unsigned char padding[BLOCK_SIZE + 8] = { 0x80 };
+    unsigned char length[8];
+    int i;
+
+    // Padding ends 8 bytes before the end of a block
+    const std::size_t padLength = (blockLength < 56) ? 56 - blockLength : 120 - blockLength;
+
+    for(i = 0; i < 8; i++)
+        length[i] = static_cast<unsigned char>(bits >> (56 - 8 * i));
+
+    update(padding, padLength);
+    update(length, 8);
+
+    std::string digest(DIGEST_SIZE, '\0');
+
+    for(i = 0; i < 8; i++)
+    {
+        digest[4 * i] = static_cast<char>(state[i] >> 24);
+        digest[4 * i + 1] = static_cast<char>(state[i] >> 16);
+        digest[4 * i + 2] = static_cast<char>(state[i] >> 8);
+        digest[4 * i + 3] = static_cast<char>(state[i]);
+    }
+
+    return digest;
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Class that calculates the SHA-256 digest of data
+ * passed in one or several parts. SHA extensions of x86
+ * processors are used when they are available
+ *
+ */
+class Sha256
+{
+    private:
+        /**
+         * @brief Size of a block in bytes
+         *
+         */
+        static const std::size_t BLOCK_SIZE = 64;
+        /**
+         * @brief Intermediate hash value
+         *
+         */
+        std::uint32_t state[8];
+        /**
+         * @brief Bytes that do not fill a whole block yet
+         *
+         */
+        unsigned char block[BLOCK_SIZE];
+        /**
+         * @brief Number of bytes in the block
+         *
+         */
+        std::size_t blockLength;
+        /**
+         * @brief Total number of bytes passed
+         *
+         */
+        std::uint64_t totalLength;
+        /**
+         * @brief Process whole blocks
+         *
+         * @param data Blocks
+         * @param count Number of blocks
+         */
+        void transform(const unsigned char* data, std::size_t count);
+
+    public:
+        /**
+         * @brief Size of the digest in bytes
+         *
+         */
+        static const std::size_t DIGEST_SIZE = 32;
+        /**
+         * @brief Initialize the hash value
+         *
+         */
+        Sha256(void);
+        /**
+         * @brief Add data to the digest
+         *
+         * @param data Data
+         * @param size Size of data in bytes
+         */
+        void update(const void* data, std::size_t size);
+        /**
+         * @brief Finish the digest. No data can be added afterwards
+         *
+         * @return Digest as a string of DIGEST_SIZE bytes
+         */
+        std::string finish(void);
+};
+
+#endif // SHA256_H
\ No newline at end of file
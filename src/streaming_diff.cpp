@@ -0,0 +1,411 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "streaming_diff.h"
+
+#include <algorithm>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+#include "color_handler.h"
+#include "diff_engine.h"
+#include "line_table.h"
+#include "line_view.h"
+#include "output_sink.h"
+
+/**
+ * @brief Open both files
+ *
+ * @param originalFilename Name of the original file
+ * @param modifiedFilename Name of the modified file
+ * @param options Program options
+ */
+StreamingDiff::StreamingDiff(const std::string& originalFilename,
+                             const std::string& modifiedFilename,
+                             Options& options) :
+    originalReader(originalFilename, options.getReadMethod(),
+                   options.getStripTrailingCr()),  // Reader of the original file
+    modifiedReader(modifiedFilename, options.getReadMethod(),
+                   options.getStripTrailingCr()),  // Reader of the modified file
+    options(options),                           // Program options
+    windowSize(options.getWindowSize()),        // Lines in each window
+    original(),                                 // Window of the original file
+    modified(),                                 // Window of the modified file
+    originalDone(false),                        // Set at the end of the file
+    modifiedDone(false) { }                     // Set at the end of the file
+
+/**
+ * @brief Read lines until the window is full or the file ends
+ *
+ * @param reader Reader of the file
+ * @param window Window of the file
+ * @param done Set at the end of the file
+ */
+void StreamingDiff::fillWindow(LineReader& reader, std::deque<std::string>& window, bool& done)
+{
+    std::string line;
+
+    while(!done && window.size() < windowSize)
+    {
+        if(reader.readLine(line))
+            window.push_back(line);
+        else
+            done = true;
+    }
+
+    // The last line of the file must be known as soon as it is read
+    if(!done) done = reader.isAtEnd();
+}
+
+/**
+ * @brief Read lines until both windows are full or files end
+ *
+ */
+void StreamingDiff::fillWindows(void)
+{
+    const bool originalNeeded = !originalDone && original.size() < windowSize;
+    const bool modifiedNeeded = !modifiedDone && modified.size() < windowSize;
+
+    // Reading and decompressing both files overlap
+    if(options.getThreadCount() > 1 && originalNeeded && modifiedNeeded)
+    {
+        std::future<void> originalFiller = std::async(std::launch::async,
+            [this]() { fillWindow(originalReader, original, originalDone); });
+
+        fillWindow(modifiedReader, modified, modifiedDone);
+        originalFiller.get();
+    }
+    else
+    {
+        fillWindow(originalReader, original, originalDone);
+        fillWindow(modifiedReader, modified, modifiedDone);
+    }
+}
+
+/**
+ * @brief Read both files to the end and check if they are identical.
+ * Reading stops at the first difference
+ *
+ * @return true if files are identical, false otherwise
+ */
+bool StreamingDiff::hasSameContents(void)
+{
+    std::string lineOld, lineNew;
+
+    while(true)
+    {
+        const bool readOld = originalReader.readLine(lineOld);
+        const bool readNew = modifiedReader.readLine(lineNew);
+
+        if(readOld != readNew || lineOld != lineNew) return false;
+
+        if(!readOld)
+            return originalReader.hasEndingNewLine() == modifiedReader.hasEndingNewLine();
+    }
+}
+
+/**
+ * @brief Check if the line of the original window is the last
+ * line of the file that does not end with a new line
+ *
+ * @param x Index of the line in the original window
+ * @return true if the line does not end with a new line, false otherwise
+ */
+bool StreamingDiff::isIncompleteOld(std::size_t x) const
+{
+    return originalDone && x + 1 == original.size() &&
+           !originalReader.hasEndingNewLine();
+}
+
+/**
+ * @brief Check if the line of the modified window is the last
+ * line of the file that does not end with a new line
+ *
+ * @param y Index of the line in the modified window
+ * @return true if the line does not end with a new line, false otherwise
+ */
+bool StreamingDiff::isIncompleteNew(std::size_t y) const
+{
+    return modifiedDone && y + 1 == modified.size() &&
+           !modifiedReader.hasEndingNewLine();
+}
+
+/**
+ * @brief Find the last pair of lines that are unique in both windows
+ * and lie within the first halves of the windows. Pairs are taken
+ * from the longest sequence that has the same order in both windows
+ *
+ * @param a IDs of lines from the original window
+ * @param b IDs of lines from the modified window
+ * @param idCount Number of distinct IDs
+ * @param x Receives the index of the line in the original window
+ * @param y Receives the index of the line in the modified window
+ * @return true if the pair was found, false otherwise
+ */
+bool StreamingDiff::findAnchor(const std::vector<std::uint32_t>& a,
+                               const std::vector<std::uint32_t>& b,
+                               std::uint32_t idCount,
+                               std::size_t& x, std::size_t& y) const
+{
+    const std::size_t halfOld = a.size() / 2;
+    const std::size_t halfNew = b.size() / 2;
+    std::vector<std::uint32_t> countOld(idCount, 0);
+    std::vector<std::uint32_t> countNew(idCount, 0);
+    std::vector<std::size_t> positionNew(idCount, 0);
+    std::size_t i;
+
+    for(i = 0; i < a.size(); i++) countOld[a[i]]++;
+
+    for(i = 0; i < b.size(); i++)
+    {
+        countNew[b[i]]++;
+        positionNew[b[i]] = i;
+    }
+
+    // Candidate pairs in the order of the original window
+    std::vector<std::size_t> candidatesOld, candidatesNew;
+
+    for(i = 0; i <= halfOld && i < a.size(); i++)
+    {
+        if(countOld[a[i]] == 1 && countNew[a[i]] == 1 &&
+           positionNew[a[i]] <= halfNew)
+        {
+            candidatesOld.push_back(i);
+            candidatesNew.push_back(positionNew[a[i]]);
+        }
+    }
+
+    if(candidatesOld.empty()) return false;
+
+    // Patience sorting: tops of piles and the previous candidate of each one
+    std::vector<std::size_t> tops;
+    std::vector<std::size_t> previous(candidatesOld.size());
+    const std::size_t none = std::numeric_limits<std::size_t>::max();
+
+    for(i = 0; i < candidatesOld.size(); i++)
+    {
+        // Find the leftmost pile whose top is not less than the candidate
+        std::size_t lo = 0, hi = tops.size(), mid;
+
+        while(lo < hi)
+        {
+            mid = (lo + hi) / 2;
+
+            if(candidatesNew[tops[mid]] < candidatesNew[i])
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        previous[i] = (lo > 0) ? tops[lo - 1] : none;
+
+        if(lo == tops.size())
+            tops.push_back(i);
+        else
+            tops[lo] = i;
+    }
+
+    // The top of the last pile ends the longest sequence
+    const std::size_t anchorOld = candidatesOld[tops.back()];
+    const std::size_t anchorNew = candidatesNew[tops.back()];
+
+    // Anchors close to the start of windows make little progress,
+    // comparing whole windows is cheaper in this case
+    if((anchorOld < halfOld / 2 && anchorNew < halfNew / 2) ||
+       (anchorOld == 0 && anchorNew == 0))
+        return false;
+
+    x = anchorOld;
+    y = anchorNew;
+    return true;
+}
+
+/**
+ * @brief Compare both windows and write the beginning of the difference
+ *
+ * @param writer Writer of hunks
+ */
+void StreamingDiff::compareWindows(HunkWriter& writer)
+{
+    const std::size_t n = original.size();
+    const std::size_t m = modified.size();
+    std::vector<LineView> viewsOld, viewsNew;
+    std::vector<std::uint32_t> a(n), b(m);
+    LineTable lineTable;
+    std::size_t i;
+
+    // Views are created first, the table keeps pointers to them
+    for(i = 0; i < n; i++) viewsOld.push_back(LineView(original[i].data(), original[i].size()));
+    for(i = 0; i < m; i++) viewsNew.push_back(LineView(modified[i].data(), modified[i].size()));
+
+    // The last line without a new line matches only the same incomplete line
+    for(i = 0; i < n; i++)
+        a[i] = isIncompleteOld(i) ? lineTable.addDistinct(viewsOld[i]) : lineTable.add(viewsOld[i]);
+
+    for(i = 0; i < m; i++)
+        b[i] = isIncompleteNew(i) ? lineTable.addDistinct(viewsNew[i]) : lineTable.add(viewsNew[i]);
+
+    if(n > 0 && m > 0 && isIncompleteOld(n - 1) && isIncompleteNew(m - 1) &&
+       viewsOld[n - 1] == viewsNew[m - 1])
+        b[m - 1] = a[n - 1];
+
+    DiffEngine engine(a, b, lineTable.size(), options);
+    std::vector<char> removed(n, 0);
+    std::vector<char> inserted(m, 0);
+    // Whether the rest of both files is in the windows
+    const bool last = originalDone && modifiedDone;
+    // Ends of the part of windows that is written
+    std::size_t endOld = n, endNew = m;
+    // Whether windows are split on the pair of equal lines
+    bool anchored = false;
+
+    if(!last && findAnchor(a, b, lineTable.size(), endOld, endNew))
+    {
+        // Lines before the anchor are compared on their own,
+        // the anchor starts the next window
+        anchored = true;
+        engine.calculate(0, endOld, 0, endNew, removed, inserted);
+    }
+    else
+    {
+        engine.calculate(0, n, 0, m, removed, inserted);
+    }
+
+    // Without an anchor only the first halves of windows are written.
+    // Decisions near the end of windows may change once more lines are read
+    const std::size_t halfOld = (n > 0) ? std::max<std::size_t>(1, n / 2) : n + 1;
+    const std::size_t halfNew = (m > 0) ? std::max<std::size_t>(1, m / 2) : m + 1;
+    std::size_t x = 0, y = 0;
+
+    while(x < endOld || y < endNew)
+    {
+        if(!last && !anchored && (x >= halfOld || y >= halfNew))
+            break;
+
+        if(x < endOld && removed[x]) // Line is removed
+        {
+            writer.add(Change::Remove, original[x], isIncompleteOld(x));
+            x++;
+        }
+        else if(y < endNew && inserted[y]) // Line is inserted
+        {
+            writer.add(Change::Insert, modified[y], isIncompleteNew(y));
+            y++;
+        }
+        else // Unchanged line
+        {
+            writer.add(Change::Equal, original[x], isIncompleteOld(x));
+            x++;
+            y++;
+        }
+    }
+
+    original.erase(original.begin(), original.begin() + x);
+    modified.erase(modified.begin(), modified.begin() + y);
+}
+
+/**
+ * @brief Calculate the difference and print it to console
+ * or write it to file while files are read
+ *
+ */
+void StreamingDiff::print(void)
+{
+    std::unique_ptr<OutputSink> out(options.getOutputToFile() ?
+        new OutputSink(options.getOutputFilePath(), options.getThreadCount() > 1) : new OutputSink());
+    // Create a smart pointer to the ColorHandler class
+    std::unique_ptr<ColorHandler> ch = nullptr;
+    // Whether to use colors (only while printing to console)
+    bool useColors = options.getUseColors() && !options.getOutputToFile();
+
+    try
+    {
+        if(useColors)
+            ch = std::unique_ptr<ColorHandler>(
+                new ColorHandler(*out, options.getForceAnsiCodes())
+            );
+    }
+    catch(std::exception& e)
+    {
+        std::cerr << "Error: " << e.what()
+                  << "\nCould not initialize colors. Try disabling them.\n";
+        return;
+    }
+
+    // Lines of binary files are meaningless, so they are only compared.
+    // Identical files are read to the end and get only the header
+    if(!options.getTreatAsText() &&
+       (originalReader.isBinary() || modifiedReader.isBinary()) &&
+       !hasSameContents())
+    {
+        *out << "Binary files " << originalReader.getFilename() << " and "
+             << modifiedReader.getFilename() << " differ\n";
+        out->finish();
+        return;
+    }
+
+    // Output the header
+
+    if(useColors) ch->setColor(Color::Red);
+    *out << "--- " << originalReader.getFilename() << '\t'
+         << originalReader.getLastModified().format() << '\n';
+    if(useColors) ch->setColor(Color::Green);
+    *out << "+++ " << modifiedReader.getFilename() << '\t'
+         << modifiedReader.getLastModified().format() << '\n';
+    if(useColors) ch->resetColor();
+
+    // Hunks are limited to the size of the window
+    HunkWriter writer(*out, ch.get(), options.getContextLines(), windowSize);
+
+    while(true)
+    {
+        fillWindows();
+
+        // Write the common head of windows
+        while(!original.empty() && !modified.empty() &&
+              original.front() == modified.front() &&
+              isIncompleteOld(0) == isIncompleteNew(0))
+        {
+            writer.add(Change::Equal, original.front(), isIncompleteOld(0));
+            original.pop_front();
+            modified.pop_front();
+        }
+
+        // Refill windows that are not full before comparing them
+        if((!originalDone && original.size() < windowSize) ||
+           (!modifiedDone && modified.size() < windowSize))
+            continue;
+
+        if(original.empty() && modified.empty()) break;
+
+        compareWindows(writer);
+    }
+
+    writer.finish();
+
+    // Colors are reset before the output is complete
+    ch.reset();
+    out->finish();
+}
\ No newline at end of file
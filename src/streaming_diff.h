@@ -0,0 +1,167 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef STREAMING_DIFF_H
+#define STREAMING_DIFF_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "hunk_writer.h"
+#include "line_reader.h"
+#include "options.h"
+
+/**
+ * @brief Class for calculating and printing difference between files
+ * that do not fit into memory. Files are read in windows of a fixed
+ * number of lines, each window is compared separately and hunks are
+ * written as soon as they are known. Windows are synchronized on lines
+ * that are unique in both of them, so the result may be longer than
+ * the shortest edit script when changes span several windows
+ *
+ */
+class StreamingDiff
+{
+    private:
+        /**
+         * @brief Reader of the original file
+         *
+         */
+        LineReader originalReader;
+        /**
+         * @brief Reader of the modified file
+         *
+         */
+        LineReader modifiedReader;
+        /**
+         * @brief Program options
+         *
+         */
+        Options& options;
+        /**
+         * @brief Maximum number of lines in each window
+         *
+         */
+        const std::size_t windowSize;
+        /**
+         * @brief Lines of the original file that are not written yet
+         *
+         */
+        std::deque<std::string> original;
+        /**
+         * @brief Lines of the modified file that are not written yet
+         *
+         */
+        std::deque<std::string> modified;
+        /**
+         * @brief Whether the whole original file is read
+         *
+         */
+        bool originalDone;
+        /**
+         * @brief Whether the whole modified file is read
+         *
+         */
+        bool modifiedDone;
+        /**
+         * @brief Read lines until the window is full or the file ends
+         *
+         * @param reader Reader of the file
+         * @param window Window of the file
+         * @param done Set at the end of the file
+         */
+        void fillWindow(LineReader& reader, std::deque<std::string>& window, bool& done);
+        /**
+         * @brief Read lines until both windows are full or files end
+         *
+         */
+        void fillWindows(void);
+        /**
+         * @brief Read both files to the end and check if they are identical.
+         * Reading stops at the first difference
+         *
+         * @return true if files are identical, false otherwise
+         */
+        bool hasSameContents(void);
+        /**
+         * @brief Check if the line of the original window is the last
+         * line of the file that does not end with a new line
+         *
+         * @param x Index of the line in the original window
+         * @return true if the line does not end with a new line, false otherwise
+         */
+        bool isIncompleteOld(std::size_t x) const;
+        /**
+         * @brief Check if the line of the modified window is the last
+         * line of the file that does not end with a new line
+         *
+         * @param y Index of the line in the modified window
+         * @return true if the line does not end with a new line, false otherwise
+         */
+        bool isIncompleteNew(std::size_t y) const;
+        /**
+         * @brief Find the last pair of lines that are unique in both windows
+         * and lie within the first halves of the windows. Pairs are taken
+         * from the longest sequence that has the same order in both windows
+         *
+         * @param a IDs of lines from the original window
+         * @param b IDs of lines from the modified window
+         * @param idCount Number of distinct IDs
+         * @param x Receives the index of the line in the original window
+         * @param y Receives the index of the line in the modified window
+         * @return true if the pair was found, false otherwise
+         */
+        bool findAnchor(const std::vector<std::uint32_t>& a,
+                        const std::vector<std::uint32_t>& b,
+                        std::uint32_t idCount,
+                        std::size_t& x, std::size_t& y) const;
+        /**
+         * @brief Compare both windows and write the beginning of the difference
+         *
+         * @param writer Writer of hunks
+         */
+        void compareWindows(HunkWriter& writer);
+
+    public:
+        /**
+         * @brief Open both files
+         *
+         * @param originalFilename Name of the original file
+         * @param modifiedFilename Name of the modified file
+         * @param options Program options
+         */
+        StreamingDiff(const std::string& originalFilename,
+                      const std::string& modifiedFilename,
+                      Options& options);
+        /**
+         * @brief Calculate the difference and print it to console
+         * or write it to file while files are read
+         *
+         */
+        void print(void);
+};
+
+#endif // STREAMING_DIFF_H
\ No newline at end of file
@@ -39,6 +39,19 @@ bool StringHelper::contains(const std::string& str, const std::string& chars)
     return str.find_first_of(chars) != std::string::npos;
 }
 
+/**
+ * @brief Check if string ends with specified suffix
+ *
+ * @param str Input string
+ * @param suffix Suffix
+ * @return true if string ends with the suffix, false otherwise
+ */
+bool StringHelper::endsWith(const std::string& str, const std::string& suffix)
+{
+    return str.size() >= suffix.size() &&
+           str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
 /**
  * @brief Check if vector contains specified string
  *
@@ -41,6 +41,14 @@ namespace StringHelper
      * @return true if string contains specified characters, false otherwise
      */
     bool contains(const std::string& str, const std::string& chars);
+    /**
+     * @brief Check if string ends with specified suffix
+     *
+     * @param str Input string
+     * @param suffix Suffix
+     * @return true if string ends with the suffix, false otherwise
+     */
+    bool endsWith(const std::string& str, const std::string& suffix);
     /**
      * @brief Check if vector contains specified string
      *
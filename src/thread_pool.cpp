@@ -0,0 +1,215 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "thread_pool.h"
+
+namespace
+{
+    /**
+     * @brief Pool the current thread is a worker of
+     *
+     */
+    thread_local const ThreadPool* currentPool = nullptr;
+    /**
+     * @brief Index of the current thread in its pool
+     *
+     */
+    thread_local std::size_t currentIndex = 0;
+}
+
+/**
+ * @brief Start worker threads
+ *
+ * @param threadCount Number of threads including the owner thread
+ */
+ThreadPool::ThreadPool(unsigned int threadCount) :
+    workers(),          // Worker threads
+    queues(),           // Queue of tasks for each thread
+    locks(),            // Lock for each queue
+    sleepLock(),        // Lock for sleeping workers
+    wakeUp(),           // Wakes up workers
+    queued(0),          // Number of tasks in all queues
+    stopping(false)     // Whether the pool is being destroyed
+{
+    // The owner thread is one of the threads
+    const std::size_t workerCount = (threadCount > 1) ? threadCount - 1 : 0;
+
+    queues.resize(workerCount + 1);
+
+    for(std::size_t i = 0; i <= workerCount; i++)
+        locks.push_back(std::unique_ptr<std::mutex>(new std::mutex()));
+
+    for(std::size_t i = 0; i < workerCount; i++)
+        workers.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+}
+
+/**
+ * @brief Run remaining tasks and stop worker threads
+ *
+ */
+ThreadPool::~ThreadPool(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepLock);
+        stopping = true;
+    }
+
+    wakeUp.notify_all();
+
+    for(std::thread& worker : workers)
+        worker.join();
+}
+
+/**
+ * @brief Get the number of threads including the owner thread
+ *
+ * @return Number of threads
+ */
+unsigned int ThreadPool::getThreadCount(void) const
+{
+    return workers.size() + 1;
+}
+
+/**
+ * @brief Get the index of the current thread in the pool.
+ * Workers have indices from 0, any other thread gets
+ * the index after the last worker
+ *
+ * @return Index of the current thread
+ */
+std::size_t ThreadPool::getCurrentIndex(void) const
+{
+    return (currentPool == this) ? currentIndex : workers.size();
+}
+
+/**
+ * @brief Take a task from the own queue or steal it from another queue
+ *
+ * @param index Index of the queue of the current thread
+ * @param task Task that was taken
+ * @return true if a task was taken, false if all queues are empty
+ */
+bool ThreadPool::takeTask(std::size_t index, std::function<void(void)>& task)
+{
+    const std::size_t count = queues.size();
+    std::size_t victim;
+    bool found = false;
+
+    {
+        // The newest task of the own queue is likely to use
+        // the same data as the task that has just finished
+        std::lock_guard<std::mutex> lock(*locks[index]);
+
+        if(!queues[index].empty())
+        {
+            task = std::move(queues[index].back());
+            queues[index].pop_back();
+            found = true;
+        }
+    }
+
+    for(std::size_t i = 1; !found && i < count; i++)
+    {
+        // The oldest task of another queue is usually the largest one
+        victim = (index + i) % count;
+
+        std::lock_guard<std::mutex> lock(*locks[victim]);
+
+        if(!queues[victim].empty())
+        {
+            task = std::move(queues[victim].front());
+            queues[victim].pop_front();
+            found = true;
+        }
+    }
+
+    if(found)
+    {
+        std::lock_guard<std::mutex> lock(sleepLock);
+        queued--;
+    }
+
+    return found;
+}
+
+/**
+ * @brief Run tasks until the pool is destroyed
+ *
+ * @param index Index of the worker
+ */
+void ThreadPool::workerLoop(std::size_t index)
+{
+    currentPool = this;
+    currentIndex = index;
+
+    while(true)
+    {
+        if(runPendingTask()) continue;
+
+        std::unique_lock<std::mutex> lock(sleepLock);
+
+        // Sleep until there is a task to take
+        wakeUp.wait(lock, [this] { return stopping || queued > 0; });
+
+        if(stopping && queued == 0) return;
+    }
+}
+
+/**
+ * @brief Add a task to the queue of the current thread
+ *
+ * @param task Task
+ */
+void ThreadPool::submit(std::function<void(void)> task)
+{
+    const std::size_t index = getCurrentIndex();
+
+    {
+        std::lock_guard<std::mutex> lock(*locks[index]);
+        queues[index].push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sleepLock);
+        queued++;
+    }
+
+    wakeUp.notify_one();
+}
+
+/**
+ * @brief Run one pending task on the current thread
+ *
+ * @return true if a task was run, false if there are no pending tasks
+ */
+bool ThreadPool::runPendingTask(void)
+{
+    std::function<void(void)> task;
+
+    if(!takeTask(getCurrentIndex(), task))
+        return false;
+
+    task();
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+/** MIT License
+ *
+ * Copyright (c) 2023 Yurii Govor
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Pool of worker threads with work stealing. Each worker has its own
+ * queue: it takes the newest task from its queue and, when the queue is
+ * empty, steals the oldest task from another queue. The thread that owns
+ * the pool has a queue as well and can help to run tasks while waiting
+ *
+ */
+class ThreadPool
+{
+    private:
+        /**
+         * @brief Worker threads
+         *
+         */
+        std::vector<std::thread> workers;
+        /**
+         * @brief Queue of tasks for each worker and for the owner thread
+         *
+         */
+        std::vector<std::deque<std::function<void(void)>>> queues;
+        /**
+         * @brief Lock for each queue
+         *
+         */
+        std::vector<std::unique_ptr<std::mutex>> locks;
+        /**
+         * @brief Lock for sleeping workers
+         *
+         */
+        std::mutex sleepLock;
+        /**
+         * @brief Wakes up workers when a task is added or the pool stops
+         *
+         */
+        std::condition_variable wakeUp;
+        /**
+         * @brief Number of tasks in all queues
+         *
+         */
+        std::size_t queued;
+        /**
+         * @brief Whether the pool is being destroyed
+         *
+         */
+        bool stopping;
+        /**
+         * @brief Take a task from the own queue or steal it from another queue
+         *
+         * @param index Index of the queue of the current thread
+         * @param task Task that was taken
+         * @return true if a task was taken, false if all queues are empty
+         */
+        bool takeTask(std::size_t index, std::function<void(void)>& task);
+        /**
+         * @brief Run tasks until the pool is destroyed
+         *
+         * @param index Index of the worker
+         */
+        void workerLoop(std::size_t index);
+
+    public:
+        /**
+         * @brief Start worker threads
+         *
+         * @param threadCount Number of threads including the owner thread
+         */
+        ThreadPool(unsigned int threadCount);
+        /**
+         * @brief Run remaining tasks and stop worker threads
+         *
+         */
+        ~ThreadPool(void);
+        /**
+         * @brief Get the number of threads including the owner thread
+         *
+         * @return Number of threads
+         */
+        unsigned int getThreadCount(void) const;
+        /**
+         * @brief Get the index of the current thread in the pool.
+         * Workers have indices from 0, any other thread gets
+         * the index after the last worker
+         *
+         * @return Index of the current thread
+         */
+        std::size_t getCurrentIndex(void) const;
+        /**
+         * @brief Add a task to the queue of the current thread
+         *
+         * @param task Task
+         */
+        void submit(std::function<void(void)> task);
+        /**
+         * @brief Run one pending task on the current thread
+         *
+         * @return true if a task was run, false if there are no pending tasks
+         */
+        bool runPendingTask(void);
+};
+
+#endif // THREAD_POOL_H
\ No newline at end of file
@@ -0,0 +1,192 @@
+#!/bin/sh
+# Command line tests of cdiff
+#
+# Usage: tests/run_tests.sh [path to cdiff]
+
+CDIFF=${1:-bin/cdiff}
+WORK=$(mktemp -d)
+FAILED=0
+
+trap 'rm -rf "$WORK"' EXIT
+
+# Report the result of the test: check NAME STATUS
+check()
+{
+    if [ "$2" -eq 0 ]; then
+        echo "PASS: $1"
+    else
+        echo "FAIL: $1"
+        FAILED=1
+    fi
+}
+
+# Create a gzip file that ends in the middle of compressed data
+truncated_gzip()
+{
+    seq 1 10000 | gzip -c | head -c 100 > "$1"
+}
+
+# Batch: a pair that cannot be compared makes the exit status non-zero,
+# while other pairs are still compared
+test_batch_error()
+{
+    printf 'a\n' > "$WORK/ba"
+    printf 'b\n' > "$WORK/bb"
+    printf '%s %s\n%s %s\n' "$WORK/missing" "$WORK/bb" "$WORK/ba" "$WORK/bb" > "$WORK/manifest"
+
+    "$CDIFF" --batch "$WORK/manifest" > "$WORK/out" 2> "$WORK/err"
+    status=$?
+
+    [ $status -eq 1 ] && grep -q '^+b$' "$WORK/out" && grep -q 'missing' "$WORK/err"
+    check "batch exits with 1 when a pair fails" $?
+}
+
+# Recursive: an unreadable file inside the tree makes the exit status non-zero
+test_recursive_error()
+{
+    mkdir -p "$WORK/ra" "$WORK/rb"
+    printf 'a\n' > "$WORK/ra/same"
+    printf 'a\n' > "$WORK/rb/same"
+    truncated_gzip "$WORK/ra/broken.gz"
+    truncated_gzip "$WORK/rb/broken.gz"
+
+    "$CDIFF" -r "$WORK/ra" "$WORK/rb" > /dev/null 2>&1
+    [ $? -eq 1 ]
+    check "recursive exits with 1 on a damaged file" $?
+
+    # Permissions do not apply to root
+    if [ "$(id -u)" -ne 0 ]; then
+        rm -f "$WORK/ra/broken.gz" "$WORK/rb/broken.gz"
+        printf 'a\n' > "$WORK/ra/locked"
+        printf 'b\n' > "$WORK/rb/locked"
+        chmod 000 "$WORK/ra/locked"
+
+        "$CDIFF" -r "$WORK/ra" "$WORK/rb" > /dev/null 2>&1
+        [ $? -eq 1 ]
+        check "recursive exits with 1 on an unreadable file" $?
+    fi
+}
+
+# Recursive: equal trees are compared successfully
+test_recursive_success()
+{
+    mkdir -p "$WORK/sa" "$WORK/sb"
+    printf 'a\n' > "$WORK/sa/file"
+    printf 'b\n' > "$WORK/sb/file"
+
+    "$CDIFF" -r "$WORK/sa" "$WORK/sb" > /dev/null 2>&1
+    check "recursive exits with 0 when all files are compared" $?
+}
+
+# Recursive: a directory that exists only in one tree is reported once
+test_recursive_only_in()
+{
+    mkdir -p "$WORK/da/only/deep" "$WORK/db"
+    printf 'a\n' > "$WORK/da/only/file"
+    printf 'a\n' > "$WORK/da/only/deep/file"
+
+    "$CDIFF" -r "$WORK/da" "$WORK/db" > "$WORK/out" 2> /dev/null
+
+    [ "$(cat "$WORK/out")" = "Only in $WORK/da: only" ]
+    check "recursive reports the top-most directory that exists in one tree" $?
+}
+
+# Incremental: removing the new line at the end of the modified file
+# gives the same hunks as a full comparison
+test_incremental_ending_newline()
+{
+    printf 'a\nb\n' > "$WORK/ia"
+    printf 'a\nb\n' > "$WORK/ib"
+    "$CDIFF" --incremental "$WORK/state" "$WORK/ia" "$WORK/ib" > /dev/null
+
+    printf 'a\nb' > "$WORK/ib"
+    "$CDIFF" --incremental "$WORK/state" "$WORK/ia" "$WORK/ib" | tail -n +3 > "$WORK/incremental"
+    "$CDIFF" "$WORK/ia" "$WORK/ib" | tail -n +3 > "$WORK/full"
+
+    grep -q 'No newline at end of file' "$WORK/incremental" &&
+        cmp -s "$WORK/incremental" "$WORK/full"
+    check "incremental notices a removed new line at the end" $?
+}
+
+# Statistics: identical binary files are not reported as different
+test_stats_identical_binary()
+{
+    printf 'a\000b\n' > "$WORK/bin1"
+    printf 'a\000b\n' > "$WORK/bin2"
+
+    "$CDIFF" --stats "$WORK/bin1" "$WORK/bin2" > "$WORK/out" 2> /dev/null
+    status=$?
+
+    [ $status -eq 0 ] && ! grep -q '^Binary files' "$WORK/out"
+    check "identical binary files do not differ with --stats" $?
+}
+
+# Line endings: lines that differ only in "\r\n" are equal with --strip-trailing-cr
+test_strip_trailing_cr()
+{
+    printf 'a\r\nb\r\n' > "$WORK/cr"
+    printf 'a\nb\n' > "$WORK/lf"
+
+    "$CDIFF" "$WORK/cr" "$WORK/lf" | grep -q '^+a$' &&
+        ! "$CDIFF" --strip-trailing-cr "$WORK/cr" "$WORK/lf" | grep -q '^@@' &&
+        ! "$CDIFF" --strip-trailing-cr --window 1 "$WORK/cr" "$WORK/lf" | grep -q '^@@'
+    check "line endings are ignored with --strip-trailing-cr" $?
+}
+
+# Output: an error while writing the output makes the exit status non-zero
+test_output_error()
+{
+    # Not every system has a device that is always full
+    [ -w /dev/full ] || return
+
+    printf 'a\n' > "$WORK/oa"
+    printf 'b\n' > "$WORK/ob"
+    ln -s /dev/full "$WORK/full.gz"
+
+    "$CDIFF" -o /dev/full "$WORK/oa" "$WORK/ob" 2> /dev/null
+    [ $? -eq 1 ]
+    check "exits with 1 when the output cannot be written" $?
+
+    "$CDIFF" -o "$WORK/full.gz" "$WORK/oa" "$WORK/ob" 2> /dev/null
+    [ $? -eq 1 ]
+    check "exits with 1 when the compressed output cannot be written" $?
+}
+
+# Server: the file cache gives the same file for both inputs,
+# which are then split on several threads
+test_client_same_file()
+{
+    seq 1 100000 > "$WORK/same"
+
+    "$CDIFF" --serve "$WORK/socket" 2> /dev/null &
+    server=$!
+
+    # Wait for the server to listen
+    tries=0
+    while [ ! -S "$WORK/socket" ] && [ $tries -lt 50 ]; do
+        sleep 0.1
+        tries=$((tries + 1))
+    done
+
+    "$CDIFF" --client "$WORK/socket" -t 4 --stats "$WORK/same" "$WORK/same" \
+        > /dev/null 2> "$WORK/err"
+    status=$?
+
+    kill $server
+    wait $server 2> /dev/null
+
+    [ $status -eq 0 ] && grep -q '^Changes: 0 removed, 0 inserted' "$WORK/err"
+    check "client compares a file with itself on several threads" $?
+}
+
+test_batch_error
+test_recursive_error
+test_recursive_success
+test_recursive_only_in
+test_incremental_ending_newline
+test_stats_identical_binary
+test_strip_trailing_cr
+test_output_error
+test_client_same_file
+
+exit $FAILED